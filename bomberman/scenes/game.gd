@@ -10,16 +10,24 @@ extends Node2D
 @onready var game_over_layer: CanvasLayer = $GameOver
 @onready var restart_button: Button = $GameOver/Panel/RestartButton
 
+## Write a state-delta stream of the match (see MatchRecorder) for spectators / archives.
+@export var record_match := false
+## If set, show this recording's keyframe (see MatchReplay) on the map after loading.
+@export_file("*.bmds") var replay_path := ""
+@export var replay_keyframe := 0
+
 var bomb_scene: PackedScene
 var power_ups_container: Node2D
+var match_recorder: MatchRecorder
 
 const TILE_SOURCE_ID := 0
+const MATCH_RECORDING_PATH := "user://last_match.bmds"
 
 func _ready() -> void:
 	if not grid_manager or not player:
 		push_error("GridManager or Player not found")
 		return
-	player.grid_manager_path = grid_manager.get_path()
+	player.grid_manager_handle = grid_manager.get_entity_handle()
 	var map_data := """
 		###################
 		#.................#
@@ -47,11 +55,37 @@ func _ready() -> void:
 		bomb_scene = load("res://scenes/bomb.tscn") as PackedScene
 	game_over_layer.visible = false
 	restart_button.pressed.connect(_on_restart_pressed)
+	if record_match:
+		_start_recording()
+	if replay_path != "":
+		show_replay_keyframe(replay_path, replay_keyframe)
 	_update_hud()
 
 func _process(_delta: float) -> void:
 	_update_hud()
 
+func _start_recording() -> void:
+	match_recorder = MatchRecorder.new()
+	match_recorder.grid_manager_handle = grid_manager.get_entity_handle()
+	add_child(match_recorder)
+	var err := match_recorder.start(MATCH_RECORDING_PATH)
+	if err != OK:
+		push_error("Could not record match to %s: %s" % [MATCH_RECORDING_PATH, error_string(err)])
+
+## Loads keyframe `index` of a recorded match into the GridManager and redraws the TileMap.
+func show_replay_keyframe(path: String, index: int) -> bool:
+	var replay := MatchReplay.new()
+	var err := replay.open(path)
+	if err != OK:
+		push_error("Could not open replay %s: %s" % [path, error_string(err)])
+		return false
+	if replay.seek_keyframe(index) != MatchReplay.RESULT_OK:
+		push_error("Replay %s has no keyframe %d" % [path, index])
+		return false
+	replay.apply_to_grid_manager(grid_manager)
+	_refresh_map_from_grid()
+	return true
+
 func _setup_map_tileset() -> void:
 	var img := Image.create(96, 32, false, Image.FORMAT_RGBA8)
 	img.fill_rect(Rect2i(0, 0, 32, 32), Color(0.7, 0.7, 0.7))
@@ -110,8 +144,8 @@ func _try_place_bomb() -> void:
 		bomb.set_grid_position(gx, gy)
 		bomb.position = grid_manager.grid_to_world(gx, gy)
 		bomb.set_flame_range(player.get_flame_range())
-		bomb.set_owner_path(player.get_path())
-		bomb.set_grid_manager_path(grid_manager.get_path())
+		bomb.set_owner_handle(player.get_entity_handle())
+		bomb.set_grid_manager_handle(grid_manager.get_entity_handle())
 		bomb.exploded.connect(_on_bomb_exploded.bind(bomb))
 		bombs_container.add_child(bomb)
 		player.place_bomb()
@@ -124,13 +158,8 @@ func _try_place_bomb() -> void:
 func _on_player_grid_position_changed(grid_pos: Vector2i) -> void:
 	print("[Phase 1] grid_position_changed: ", grid_pos)
 
-func _on_bomb_exploded(_gx: int, _gy: int, tiles: Array, bomb: Bomb) -> void:
-	var player_cell := Vector2i(player.get_grid_x(), player.get_grid_y())
-	for i in range(tiles.size()):
-		if tiles[i] == player_cell and player.get_is_alive():
-			player.die()
-			break
-	player.on_bomb_exploded()
+func _on_bomb_exploded(_gx: int, _gy: int, _tiles: Array, bomb: Bomb) -> void:
+	# Bomb already killed players in the blast and returned the slot to its owner.
 	if bomb and is_instance_valid(bomb):
 		bomb.queue_free()
 
@@ -158,11 +187,7 @@ func _on_tile_destroyed(x: int, y: int) -> void:
 	power_ups_container.add_child(pu)
 
 func _on_power_up_collected(p: Player) -> void:
-	if p == player:
-		if player.get_flame_range() < 5:
-			player.set_flame_range(player.get_flame_range() + 1)
-		elif player.get_bomb_capacity() < 5:
-			player.set_bomb_capacity(player.get_bomb_capacity() + 1)
+	p.collect_power_up()
 
 func _on_restart_pressed() -> void:
 	get_tree().reload_current_scene()
@@ -0,0 +1,53 @@
+#ifndef BOMBERMAN_SERVER_BOT_CLIENT_H
+#define BOMBERMAN_SERVER_BOT_CLIENT_H
+
+#include "room.h"
+
+#include <cstdint>
+
+namespace bomberman {
+
+/**
+ * In-process stand-in for a network client: produces one PlayerInput per tick.
+ * Random walk at roughly Player::move_speed cells per second, drops a bomb now and then.
+ */
+class BotClient {
+private:
+	uint64_t rng_state;
+	int move_chance_per_mille;
+	int bomb_chance_per_mille;
+
+	uint32_t _next_random() {
+		rng_state ^= rng_state >> 12;
+		rng_state ^= rng_state << 25;
+		rng_state ^= rng_state >> 27;
+		return (uint32_t)((rng_state * 0x2545F4914F6CDD1Dull) >> 32);
+	}
+
+public:
+	explicit BotClient(uint64_t p_seed = 1, int p_tick_rate = 60) :
+			rng_state(p_seed ? p_seed : 1) {
+		// ~3 moves per second (Player default move_speed), ~1 bomb every 4 seconds.
+		move_chance_per_mille = p_tick_rate > 0 ? 3000 / p_tick_rate : 50;
+		bomb_chance_per_mille = p_tick_rate > 0 ? 250 / p_tick_rate : 4;
+		if (bomb_chance_per_mille < 1) bomb_chance_per_mille = 1;
+	}
+
+	PlayerInput poll(const Room &p_room, int p_player) {
+		PlayerInput input;
+		const Room::RoomPlayer &self = p_room.get_player(p_player);
+		if (!self.is_alive) return input;
+		if ((int)(_next_random() % 1000) < move_chance_per_mille) {
+			static const int8_t DIRS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+			const int8_t *dir = DIRS[_next_random() % 4];
+			input.dx = dir[0];
+			input.dy = dir[1];
+		}
+		input.place_bomb = (int)(_next_random() % 1000) < bomb_chance_per_mille;
+		return input;
+	}
+};
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_SERVER_BOT_CLIENT_H
@@ -0,0 +1,118 @@
+// Headless multi-room server: runs many independent matches with in-process bot clients
+// and reports per-room tick latency. See server/README.md.
+
+#include "room_server.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace bomberman;
+
+static void print_usage(const char *p_program) {
+	std::printf("Usage: %s [options]\n"
+				"  --rooms N          rooms to host (default 500)\n"
+				"  --players N        players per room (default 4)\n"
+				"  --threads N        worker threads, 0 = all cores (default 0)\n"
+				"  --tick-rate HZ     fixed tick rate per room (default 60)\n"
+				"  --duration SEC     run time in seconds (default 10)\n"
+				"  --seed N           base RNG seed (default 1)\n"
+				"  --per-room         print every room instead of the 10 slowest\n",
+			p_program);
+}
+
+static double to_micros(uint64_t p_nanos) {
+	return (double)p_nanos / 1000.0;
+}
+
+static void print_room(const RoomReport &p_report) {
+	const TickHistogram &h = p_report.latency;
+	std::printf("  room %4d  shard %2d  ticks %7llu  p50 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f  misses %llu  skipped %llu  matches %u\n",
+			p_report.room_id, p_report.shard, (unsigned long long)p_report.ticks,
+			to_micros(h.percentile(0.50)), to_micros(h.percentile(0.99)), to_micros(h.percentile(0.999)),
+			to_micros(h.get_max()), (unsigned long long)p_report.deadline_misses,
+			(unsigned long long)p_report.skipped_ticks, p_report.matches_finished);
+}
+
+int main(int argc, char **argv) {
+	ServerConfig config;
+	bool per_room = false;
+
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (std::strcmp(arg, "--per-room") == 0) {
+			per_room = true;
+		} else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+			print_usage(argv[0]);
+			return 0;
+		} else if (value && std::strcmp(arg, "--rooms") == 0) {
+			config.room_count = std::atoi(value);
+			i++;
+		} else if (value && std::strcmp(arg, "--players") == 0) {
+			config.room.player_count = std::atoi(value);
+			i++;
+		} else if (value && std::strcmp(arg, "--threads") == 0) {
+			config.threads = std::atoi(value);
+			i++;
+		} else if (value && std::strcmp(arg, "--tick-rate") == 0) {
+			config.room.tick_rate = std::atoi(value);
+			i++;
+		} else if (value && std::strcmp(arg, "--duration") == 0) {
+			config.duration_seconds = std::atof(value);
+			i++;
+		} else if (value && std::strcmp(arg, "--seed") == 0) {
+			config.room.seed = std::strtoull(value, nullptr, 10);
+			i++;
+		} else {
+			std::fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	RoomServer server(config);
+	std::printf("bomberman_server: %d rooms x %d players, %d threads, %d Hz, %.1f s\n",
+			config.room_count, config.room.player_count, server.get_thread_count(),
+			config.room.tick_rate, config.duration_seconds);
+	server.run();
+
+	const std::vector<RoomReport> &reports = server.get_reports();
+	TickHistogram all;
+	uint64_t ticks = 0;
+	uint64_t misses = 0;
+	uint64_t skipped = 0;
+	for (const RoomReport &r : reports) {
+		all.merge(r.latency);
+		ticks += r.ticks;
+		misses += r.deadline_misses;
+		skipped += r.skipped_ticks;
+	}
+	uint64_t expected = (uint64_t)((double)config.room_count * config.room.tick_rate * config.duration_seconds);
+
+	std::printf("ticks %llu / %llu expected (%.1f%%), deadline misses %llu, skipped %llu, arena %.1f MiB\n",
+			(unsigned long long)ticks, (unsigned long long)expected,
+			expected ? 100.0 * (double)ticks / (double)expected : 0.0,
+			(unsigned long long)misses, (unsigned long long)skipped,
+			(double)server.get_arena_bytes_reserved() / (1024.0 * 1024.0));
+	std::printf("tick latency (us), all rooms: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+			to_micros(all.percentile(0.50)), to_micros(all.percentile(0.90)), to_micros(all.percentile(0.99)),
+			to_micros(all.percentile(0.999)), to_micros(all.get_max()));
+
+	if (per_room) {
+		std::printf("per-room tick latency (us):\n");
+		for (const RoomReport &r : reports) print_room(r);
+	} else {
+		std::vector<const RoomReport *> slowest;
+		for (const RoomReport &r : reports) slowest.push_back(&r);
+		std::sort(slowest.begin(), slowest.end(), [](const RoomReport *a, const RoomReport *b) {
+			return a->latency.percentile(0.99) > b->latency.percentile(0.99);
+		});
+		if (slowest.size() > 10) slowest.resize(10);
+		std::printf("slowest rooms by p99 tick latency (us):\n");
+		for (const RoomReport *r : slowest) print_room(*r);
+	}
+	return 0;
+}
@@ -0,0 +1,152 @@
+#include "room.h"
+
+#include <cstring>
+
+namespace bomberman {
+
+// Same layout game.gd loads into GridManager.
+static const char *DEFAULT_MAP =
+		"###################\n"
+		"#.................#\n"
+		"#.xxx.xxx.xxx.xxx.#\n"
+		"#.................#\n"
+		"#.xxx.xxx.xxx.xxx.#\n"
+		"#.................#\n"
+		"#.xxx.xxx.xxx.xxx.#\n"
+		"#.................#\n"
+		"###################\n";
+
+Room::Room(const RoomConfig &p_config, Arena *p_arena) :
+		config(p_config),
+		grid(p_config.map_width, p_config.map_height, ArenaAllocator<uint8_t>(p_arena)),
+		players(ArenaAllocator<RoomPlayer>(p_arena)),
+		inputs(ArenaAllocator<PlayerInput>(p_arena)),
+		bombs(ArenaAllocator<RoomBomb>(p_arena)),
+		power_ups(ArenaAllocator<RoomPowerUp>(p_arena)),
+		blast_cells(ArenaAllocator<Cell>(p_arena)),
+		rng_state(p_config.seed ? p_config.seed : 0x9E3779B97F4A7C15ull) {
+	if (!config.map_data) config.map_data = DEFAULT_MAP;
+	if (config.player_count < 1) config.player_count = 1;
+	if (config.tick_rate < 1) config.tick_rate = 1;
+	// Reserve worst cases once; the arena never gets a second request from this room.
+	players.resize((size_t)config.player_count);
+	inputs.resize((size_t)config.player_count);
+	bombs.reserve((size_t)config.player_count * MAX_BOMB_CAPACITY);
+	power_ups.reserve((size_t)grid.get_width() * (size_t)grid.get_height());
+	blast_cells.reserve(max_blast_cells(MAX_FLAME_RANGE, grid.get_width(), grid.get_height()));
+	_start_match();
+}
+
+uint32_t Room::_next_random() {
+	// xorshift64*: per-room, deterministic for a given seed.
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return (uint32_t)((rng_state * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+void Room::_start_match() {
+	grid.load_from_string(config.map_data, std::strlen(config.map_data));
+	bombs.clear();
+	power_ups.clear();
+	int w = grid.get_width();
+	int h = grid.get_height();
+	const int spawn_x[4] = { 1, w - 2, w - 2, 1 };
+	const int spawn_y[4] = { 1, h - 2, 1, h - 2 };
+	for (size_t i = 0; i < players.size(); i++) {
+		RoomPlayer &p = players[i];
+		p = RoomPlayer();
+		p.grid_x = spawn_x[i % 4];
+		p.grid_y = spawn_y[i % 4];
+		inputs[i] = PlayerInput();
+	}
+}
+
+void Room::set_input(int p_player, const PlayerInput &p_input) {
+	if (p_player < 0 || p_player >= (int)inputs.size()) return;
+	inputs[(size_t)p_player] = p_input;
+}
+
+void Room::_apply_input(int p_player, const PlayerInput &p_input) {
+	RoomPlayer &p = players[(size_t)p_player];
+	if ((p_input.dx != 0 || p_input.dy != 0) && try_move(p, grid, p_input.dx, p_input.dy)) {
+		_collect_power_up(p);
+	}
+	if (p_input.place_bomb && place_bomb(p)) {
+		RoomBomb bomb;
+		bomb.grid_x = p.grid_x;
+		bomb.grid_y = p.grid_y;
+		bomb.owner = p_player;
+		bomb.flame_range = p.flame_range;
+		bombs.push_back(bomb);
+	}
+}
+
+void Room::_collect_power_up(RoomPlayer &p_player) {
+	for (size_t i = 0; i < power_ups.size(); i++) {
+		if (power_ups[i].grid_x != p_player.grid_x || power_ups[i].grid_y != p_player.grid_y) continue;
+		apply_power_up(p_player);
+		power_ups[i] = power_ups.back();
+		power_ups.pop_back();
+		return;
+	}
+}
+
+void Room::_explode(const RoomBomb &p_bomb) {
+	blast_cells.clear();
+	collect_blast_cells(grid, p_bomb.grid_x, p_bomb.grid_y, p_bomb.flame_range, [this](int x, int y) {
+		blast_cells.push_back(Cell{ x, y });
+	});
+	for (const Cell &c : blast_cells) {
+		// game.gd _on_tile_destroyed: roll for a power-up on every destroyed tile.
+		if (grid.destroy_tile(c.x, c.y)) {
+			if ((double)_next_random() / 4294967296.0 < config.power_up_chance) {
+				RoomPowerUp pu;
+				pu.grid_x = c.x;
+				pu.grid_y = c.y;
+				pu.type = (int)(_next_random() % 3);
+				power_ups.push_back(pu);
+			}
+		}
+	}
+	for (RoomPlayer &p : players) {
+		catch_in_blast(p, blast_cells);
+	}
+	if (p_bomb.owner >= 0 && p_bomb.owner < (int)players.size()) {
+		release_bomb(players[(size_t)p_bomb.owner]);
+	}
+}
+
+void Room::tick() {
+	double delta = 1.0 / config.tick_rate;
+	for (size_t i = 0; i < inputs.size(); i++) {
+		_apply_input((int)i, inputs[i]);
+		inputs[i] = PlayerInput();
+	}
+
+	size_t i = 0;
+	while (i < bombs.size()) {
+		bombs[i].timer += delta;
+		if (bombs[i].timer >= config.bomb_time) {
+			RoomBomb bomb = bombs[i];
+			bombs[i] = bombs.back();
+			bombs.pop_back();
+			_explode(bomb);
+			continue;
+		}
+		i++;
+	}
+
+	tick_count++;
+
+	int alive = 0;
+	for (const RoomPlayer &p : players) {
+		if (p.is_alive) alive++;
+	}
+	if (alive == 0 || (players.size() > 1 && alive <= 1)) {
+		matches_finished++;
+		_start_match();
+	}
+}
+
+} // namespace bomberman
@@ -0,0 +1,102 @@
+#ifndef BOMBERMAN_SERVER_ROOM_H
+#define BOMBERMAN_SERVER_ROOM_H
+
+#include "arena.h"
+#include "game_rules.h"
+#include "grid_state.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace bomberman {
+
+/** One player's input for a single tick. dx/dy in grid units (-1, 0, 1). */
+struct PlayerInput {
+	int8_t dx = 0;
+	int8_t dy = 0;
+	bool place_bomb = false;
+};
+
+struct RoomConfig {
+	int player_count = 4;
+	int tick_rate = 60;
+	double bomb_time = 2.0;
+	double power_up_chance = 0.4;
+	uint64_t seed = 1;
+	/** Map text in GridManager::load_map_from_string format; must outlive the room. */
+	const char *map_data = nullptr;
+	int map_width = 19;
+	int map_height = 9;
+};
+
+/**
+ * Headless match driven by the same rules as the Player/Bomb nodes (game_rules.h) on top of
+ * the shared GridState, plus the scene glue game.gd performs (power-up roll on tile
+ * destruction, pickup on the same cell). All storage comes from one Arena and is reserved up
+ * front, so tick() never allocates. Not thread-safe; a room is owned by one shard thread.
+ */
+class Room {
+public:
+	struct RoomPlayer {
+		int grid_x = 0;
+		int grid_y = 0;
+		int bomb_capacity = 1;
+		int active_bombs = 0;
+		int flame_range = 1;
+		bool is_alive = true;
+	};
+
+	struct RoomBomb {
+		int grid_x = 0;
+		int grid_y = 0;
+		int owner = -1;
+		int flame_range = 1;
+		double timer = 0.0;
+	};
+
+	struct RoomPowerUp {
+		int grid_x = 0;
+		int grid_y = 0;
+		int type = 0;
+	};
+
+private:
+	struct Cell {
+		int x;
+		int y;
+	};
+
+	RoomConfig config;
+	BasicGridState<ArenaAllocator<uint8_t>> grid;
+	std::vector<RoomPlayer, ArenaAllocator<RoomPlayer>> players;
+	std::vector<PlayerInput, ArenaAllocator<PlayerInput>> inputs;
+	std::vector<RoomBomb, ArenaAllocator<RoomBomb>> bombs;
+	std::vector<RoomPowerUp, ArenaAllocator<RoomPowerUp>> power_ups;
+	std::vector<Cell, ArenaAllocator<Cell>> blast_cells;
+	uint64_t rng_state;
+	uint64_t tick_count = 0;
+	uint32_t matches_finished = 0;
+
+	uint32_t _next_random();
+	void _start_match();
+	void _apply_input(int p_player, const PlayerInput &p_input);
+	void _collect_power_up(RoomPlayer &p_player);
+	void _explode(const RoomBomb &p_bomb);
+
+public:
+	Room(const RoomConfig &p_config, Arena *p_arena);
+
+	void set_input(int p_player, const PlayerInput &p_input);
+	/** Advances the match by one fixed step of 1 / tick_rate seconds. Restarts finished matches. */
+	void tick();
+
+	int get_player_count() const { return (int)players.size(); }
+	const RoomPlayer &get_player(int p_index) const { return players[(size_t)p_index]; }
+	const BasicGridState<ArenaAllocator<uint8_t>> &get_grid() const { return grid; }
+	uint64_t get_tick_count() const { return tick_count; }
+	uint32_t get_matches_finished() const { return matches_finished; }
+};
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_SERVER_ROOM_H
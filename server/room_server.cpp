@@ -0,0 +1,180 @@
+#include "room_server.h"
+#include "bot_client.h"
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <thread>
+
+namespace bomberman {
+
+typedef std::chrono::steady_clock Clock;
+
+namespace {
+
+struct ShardRoom {
+	Room *room = nullptr;
+	BotClient *bots = nullptr;
+	TickHistogram *latency = nullptr;
+	uint64_t deadline_misses = 0;
+	uint64_t skipped_ticks = 0;
+	int room_id = 0;
+};
+
+struct DeadlineEntry {
+	Clock::time_point deadline;
+	uint32_t slot;
+
+	// Min-heap on deadline via std::push_heap/pop_heap.
+	bool operator<(const DeadlineEntry &p_other) const { return deadline > p_other.deadline; }
+};
+
+template <typename T, typename... Args>
+T *arena_new(Arena &p_arena, Args &&...p_args) {
+	return new (p_arena.allocate(sizeof(T), alignof(T))) T(static_cast<Args &&>(p_args)...);
+}
+
+uint64_t room_seed(uint64_t p_base, int p_room_id, int p_player) {
+	// splitmix64 so neighbouring rooms/players get unrelated streams.
+	uint64_t z = p_base + 0x9E3779B97F4A7C15ull * (uint64_t)(p_room_id * 16 + p_player + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+/** Body of one shard thread. Everything it touches is either const or owned by this call. */
+void run_shard(const ServerConfig &p_config, int p_shard, int p_shard_count, Clock::time_point p_start,
+		Clock::time_point p_end, std::vector<RoomReport> &r_reports, size_t &r_arena_bytes) {
+	Arena arena(p_config.arena_chunk_size);
+
+	int room_count = 0;
+	for (int id = p_shard; id < p_config.room_count; id += p_shard_count) room_count++;
+
+	ShardRoom *rooms = static_cast<ShardRoom *>(arena.allocate(sizeof(ShardRoom) * (size_t)room_count, alignof(ShardRoom)));
+	std::vector<DeadlineEntry, ArenaAllocator<DeadlineEntry>> queue{ ArenaAllocator<DeadlineEntry>(&arena) };
+	queue.reserve((size_t)room_count);
+
+	const Clock::duration period = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(1.0 / p_config.room.tick_rate));
+	const Clock::duration max_lag = period * p_config.max_catchup_ticks;
+
+	for (int i = 0; i < room_count; i++) {
+		int room_id = p_shard + i * p_shard_count;
+		RoomConfig room_config = p_config.room;
+		room_config.seed = room_seed(p_config.room.seed, room_id, 0);
+		ShardRoom &sr = *new (&rooms[i]) ShardRoom();
+		sr.room_id = room_id;
+		sr.room = arena_new<Room>(arena, room_config, &arena);
+		sr.bots = static_cast<BotClient *>(arena.allocate(sizeof(BotClient) * (size_t)room_config.player_count, alignof(BotClient)));
+		for (int p = 0; p < room_config.player_count; p++) {
+			new (&sr.bots[p]) BotClient(room_seed(p_config.room.seed, room_id, p + 1), room_config.tick_rate);
+		}
+		sr.latency = arena_new<TickHistogram>(arena);
+		// Stagger first deadlines across one period so the shard's load is spread evenly.
+		queue.push_back(DeadlineEntry{ p_start + period * i / room_count, (uint32_t)i });
+	}
+	std::make_heap(queue.begin(), queue.end());
+
+	while (!queue.empty()) {
+		std::pop_heap(queue.begin(), queue.end());
+		DeadlineEntry entry = queue.back();
+		queue.pop_back();
+		if (entry.deadline >= p_end) {
+			// Earliest pending deadline is past the end: every room is done.
+			break;
+		}
+
+		Clock::time_point now = Clock::now();
+		if (now < entry.deadline) {
+			std::this_thread::sleep_until(entry.deadline);
+			now = Clock::now();
+		}
+
+		ShardRoom &sr = rooms[entry.slot];
+		if (now - entry.deadline > max_lag) {
+			uint64_t behind = (uint64_t)((now - entry.deadline) / period);
+			sr.skipped_ticks += behind;
+			entry.deadline += period * (Clock::rep)behind;
+		}
+
+		Room &room = *sr.room;
+		for (int p = 0; p < room.get_player_count(); p++) {
+			room.set_input(p, sr.bots[p].poll(room, p));
+		}
+		Clock::time_point tick_start = Clock::now();
+		room.tick();
+		Clock::time_point tick_end = Clock::now();
+
+		sr.latency->record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(tick_end - tick_start).count());
+		if (tick_end - entry.deadline > period) {
+			sr.deadline_misses++;
+		}
+
+		entry.deadline += period;
+		queue.push_back(entry);
+		std::push_heap(queue.begin(), queue.end());
+	}
+
+	r_reports.resize((size_t)room_count);
+	for (int i = 0; i < room_count; i++) {
+		ShardRoom &sr = rooms[i];
+		RoomReport &report = r_reports[(size_t)i];
+		report.room_id = sr.room_id;
+		report.shard = p_shard;
+		report.ticks = sr.room->get_tick_count();
+		report.deadline_misses = sr.deadline_misses;
+		report.skipped_ticks = sr.skipped_ticks;
+		report.matches_finished = sr.room->get_matches_finished();
+		report.latency = *sr.latency;
+		sr.room->~Room();
+	}
+	r_arena_bytes = arena.get_bytes_reserved();
+}
+
+} // namespace
+
+RoomServer::RoomServer(const ServerConfig &p_config) :
+		config(p_config) {
+	if (config.room_count < 0) config.room_count = 0;
+	if (config.room.tick_rate < 1) config.room.tick_rate = 1;
+	if (config.max_catchup_ticks < 1) config.max_catchup_ticks = 1;
+}
+
+int RoomServer::get_thread_count() const {
+	int threads = config.threads;
+	if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+	if (threads <= 0) threads = 1;
+	if (threads > config.room_count) threads = config.room_count > 0 ? config.room_count : 1;
+	return threads;
+}
+
+void RoomServer::run() {
+	int shard_count = get_thread_count();
+	std::vector<std::vector<RoomReport>> shard_reports((size_t)shard_count);
+	std::vector<size_t> shard_arena_bytes((size_t)shard_count, 0);
+
+	// Small lead so every thread has built its rooms before the first deadline.
+	Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+	Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(config.duration_seconds));
+
+	std::vector<std::thread> threads;
+	threads.reserve((size_t)shard_count);
+	for (int s = 0; s < shard_count; s++) {
+		threads.emplace_back(run_shard, std::cref(config), s, shard_count, start, end,
+				std::ref(shard_reports[(size_t)s]), std::ref(shard_arena_bytes[(size_t)s]));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+
+	reports.clear();
+	arena_bytes_reserved = 0;
+	for (int s = 0; s < shard_count; s++) {
+		for (RoomReport &r : shard_reports[(size_t)s]) reports.push_back(r);
+		arena_bytes_reserved += shard_arena_bytes[(size_t)s];
+	}
+	std::sort(reports.begin(), reports.end(), [](const RoomReport &a, const RoomReport &b) { return a.room_id < b.room_id; });
+}
+
+} // namespace bomberman
@@ -0,0 +1,59 @@
+#ifndef BOMBERMAN_SERVER_ROOM_SERVER_H
+#define BOMBERMAN_SERVER_ROOM_SERVER_H
+
+#include "room.h"
+#include "tick_histogram.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bomberman {
+
+struct ServerConfig {
+	int room_count = 500;
+	int threads = 0; // 0 = hardware concurrency
+	double duration_seconds = 10.0;
+	/** A room more than this many periods behind drops ticks instead of trying to catch up. */
+	int max_catchup_ticks = 4;
+	size_t arena_chunk_size = 256 * 1024;
+	RoomConfig room;
+};
+
+/** Per-room results, copied out of the shard after its thread has joined. */
+struct RoomReport {
+	int room_id = 0;
+	int shard = 0;
+	uint64_t ticks = 0;
+	uint64_t deadline_misses = 0; // tick finished more than one period after its deadline
+	uint64_t skipped_ticks = 0; // ticks dropped because the room fell too far behind
+	uint32_t matches_finished = 0;
+	TickHistogram latency;
+};
+
+/**
+ * Hosts many independent Rooms on a fixed pool of threads. Rooms are sharded round-robin;
+ * each shard thread owns its Arena, rooms, bots and reports, so no mutable state is shared
+ * between threads while running. Within a shard, rooms are ticked earliest-deadline-first at
+ * the configured tick rate.
+ */
+class RoomServer {
+private:
+	ServerConfig config;
+	std::vector<RoomReport> reports;
+	size_t arena_bytes_reserved = 0;
+
+public:
+	explicit RoomServer(const ServerConfig &p_config);
+
+	/** Blocks for duration_seconds, then fills get_reports(). */
+	void run();
+
+	int get_thread_count() const;
+	const std::vector<RoomReport> &get_reports() const { return reports; }
+	size_t get_arena_bytes_reserved() const { return arena_bytes_reserved; }
+};
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_SERVER_ROOM_SERVER_H
@@ -0,0 +1,85 @@
+#ifndef BOMBERMAN_SERVER_TICK_HISTOGRAM_H
+#define BOMBERMAN_SERVER_TICK_HISTOGRAM_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace bomberman {
+
+/**
+ * Fixed-size log-linear latency histogram in nanoseconds (16 sub-buckets per power of two,
+ * ~6% relative error). record() is allocation-free; histograms merge by addition.
+ */
+class TickHistogram {
+public:
+	static constexpr int SUB_BITS = 4;
+	static constexpr int SUB_COUNT = 1 << SUB_BITS;
+	static constexpr int BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+private:
+	uint32_t buckets[BUCKET_COUNT];
+	uint64_t count = 0;
+	uint64_t max_value = 0;
+
+	static int _msb(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - __builtin_clzll(v);
+#else
+		int bit = 0;
+		while (v >>= 1) bit++;
+		return bit;
+#endif
+	}
+
+	static int _bucket_of(uint64_t v) {
+		if (v < (uint64_t)SUB_COUNT) return (int)v;
+		int shift = _msb(v) - SUB_BITS;
+		return (shift + 1) * SUB_COUNT + (int)((v >> shift) & (SUB_COUNT - 1));
+	}
+
+	/** Largest value that maps to bucket b. */
+	static uint64_t _bucket_upper(int b) {
+		if (b < SUB_COUNT) return (uint64_t)b;
+		int shift = b / SUB_COUNT - 1;
+		uint64_t lower = (uint64_t)(SUB_COUNT + b % SUB_COUNT) << shift;
+		return lower + ((uint64_t)1 << shift) - 1;
+	}
+
+public:
+	TickHistogram() { std::memset(buckets, 0, sizeof(buckets)); }
+
+	void record(uint64_t p_nanos) {
+		buckets[_bucket_of(p_nanos)]++;
+		count++;
+		if (p_nanos > max_value) max_value = p_nanos;
+	}
+
+	void merge(const TickHistogram &p_other) {
+		for (int i = 0; i < BUCKET_COUNT; i++) buckets[i] += p_other.buckets[i];
+		count += p_other.count;
+		if (p_other.max_value > max_value) max_value = p_other.max_value;
+	}
+
+	uint64_t get_count() const { return count; }
+	uint64_t get_max() const { return max_value; }
+
+	/** p_quantile in [0, 1]; returns the bucket's upper bound, clamped to the observed max. */
+	uint64_t percentile(double p_quantile) const {
+		if (count == 0) return 0;
+		uint64_t rank = (uint64_t)(p_quantile * (double)count);
+		if (rank >= count) rank = count - 1;
+		uint64_t seen = 0;
+		for (int i = 0; i < BUCKET_COUNT; i++) {
+			seen += buckets[i];
+			if (seen > rank) {
+				uint64_t upper = _bucket_upper(i);
+				return upper < max_value ? upper : max_value;
+			}
+		}
+		return max_value;
+	}
+};
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_SERVER_TICK_HISTOGRAM_H
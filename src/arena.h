@@ -0,0 +1,143 @@
+#ifndef BOMBERMAN_ARENA_H
+#define BOMBERMAN_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace bomberman {
+
+/**
+ * Chunked bump allocator. Engine-independent (no godot-cpp) so the headless server can use it.
+ * deallocate() is a no-op; memory is returned all at once by reset() or the destructor.
+ * Not thread-safe: one Arena per thread.
+ *
+ * reset() folds overflow chunks into a single chunk sized for the largest frame seen, so an
+ * arena reset once per tick stops calling malloc after warm-up.
+ */
+class Arena {
+private:
+	struct Chunk {
+		Chunk *next;
+		size_t capacity;
+		size_t used;
+		// payload follows
+		unsigned char *data() { return reinterpret_cast<unsigned char *>(this + 1); }
+	};
+
+	size_t chunk_size;
+	Chunk *head = nullptr;
+	size_t bytes_used = 0;
+	size_t bytes_reserved = 0;
+	size_t peak_bytes_used = 0;
+	uint64_t chunk_allocations = 0;
+	uint64_t frame_index = 0;
+
+	void _free_chunks() {
+		while (head) {
+			Chunk *next = head->next;
+			std::free(head);
+			head = next;
+		}
+		bytes_reserved = 0;
+	}
+
+	Chunk *_new_chunk(size_t p_min_size) {
+		size_t capacity = p_min_size > chunk_size ? p_min_size : chunk_size;
+		Chunk *chunk = static_cast<Chunk *>(std::malloc(sizeof(Chunk) + capacity));
+		// The extension builds with -fno-exceptions; out of memory is fatal either way.
+		if (!chunk) std::abort();
+		chunk->next = head;
+		chunk->capacity = capacity;
+		chunk->used = 0;
+		head = chunk;
+		bytes_reserved += capacity;
+		chunk_allocations++;
+		return chunk;
+	}
+
+public:
+	explicit Arena(size_t p_chunk_size = 64 * 1024) :
+			chunk_size(p_chunk_size) {}
+	~Arena() { _free_chunks(); }
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+	void *allocate(size_t p_size, size_t p_align = alignof(std::max_align_t)) {
+		Chunk *chunk = head;
+		if (chunk) {
+			uintptr_t base = reinterpret_cast<uintptr_t>(chunk->data());
+			uintptr_t ptr = (base + chunk->used + p_align - 1) & ~(uintptr_t)(p_align - 1);
+			if (ptr + p_size <= base + chunk->capacity) {
+				bytes_used += (ptr + p_size) - (base + chunk->used);
+				chunk->used = (ptr + p_size) - base;
+				if (bytes_used > peak_bytes_used) peak_bytes_used = bytes_used;
+				return reinterpret_cast<void *>(ptr);
+			}
+		}
+		chunk = _new_chunk(p_size + p_align);
+		uintptr_t base = reinterpret_cast<uintptr_t>(chunk->data());
+		uintptr_t ptr = (base + p_align - 1) & ~(uintptr_t)(p_align - 1);
+		chunk->used = (ptr + p_size) - base;
+		bytes_used += chunk->used;
+		if (bytes_used > peak_bytes_used) peak_bytes_used = bytes_used;
+		return reinterpret_cast<void *>(ptr);
+	}
+
+	/** Releases every allocation at once and starts a new frame (see get_frame_index). */
+	void reset() {
+		if (head && head->next) {
+			// Overflowed this frame: replace the chain with one chunk that fits all of it.
+			size_t total = bytes_reserved;
+			_free_chunks();
+			if (total > chunk_size) chunk_size = total;
+			_new_chunk(chunk_size);
+		}
+		if (head) {
+#ifdef DEBUG_ENABLED
+			// Poison so reads through pointers that escaped the frame are obvious.
+			std::memset(head->data(), 0xCD, head->used);
+#endif
+			head->used = 0;
+		}
+		bytes_used = 0;
+		frame_index++;
+	}
+
+	size_t get_bytes_used() const { return bytes_used; }
+	size_t get_bytes_reserved() const { return bytes_reserved; }
+	/** Highest get_bytes_used() seen in any single frame. */
+	size_t get_peak_bytes_used() const { return peak_bytes_used; }
+	/** Number of malloc calls made for chunks; flat in steady state. */
+	uint64_t get_chunk_allocations() const { return chunk_allocations; }
+	/** Incremented by every reset(); used to detect allocations outliving their frame. */
+	uint64_t get_frame_index() const { return frame_index; }
+};
+
+/** std-compatible allocator over an Arena; containers using it must not outlive the arena. */
+template <typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	Arena *arena;
+
+	explicit ArenaAllocator(Arena *p_arena) :
+			arena(p_arena) {}
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &p_other) :
+			arena(p_other.arena) {}
+
+	T *allocate(size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+	void deallocate(T *, size_t) {}
+
+	template <typename U>
+	bool operator==(const ArenaAllocator<U> &p_other) const { return arena == p_other.arena; }
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U> &p_other) const { return arena != p_other.arena; }
+};
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_ARENA_H
@@ -1,5 +1,7 @@
 #include "bomb.h"
 #include "grid_manager.h"
+#include "player.h"
+#include "game_rules.h"
 #include <godot_cpp/core/class_db.hpp>
 
 namespace godot {
@@ -7,6 +9,7 @@ namespace godot {
 void Bomb::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("explode"), &Bomb::explode);
 	ClassDB::bind_method(D_METHOD("get_explosion_tiles"), &Bomb::get_explosion_tiles);
+	ClassDB::bind_method(D_METHOD("get_entity_handle"), &Bomb::get_entity_handle);
 	ClassDB::bind_method(D_METHOD("set_grid_x", "x"), &Bomb::set_grid_x);
 	ClassDB::bind_method(D_METHOD("get_grid_x"), &Bomb::get_grid_x);
 	ClassDB::bind_method(D_METHOD("set_grid_y", "y"), &Bomb::set_grid_y);
@@ -16,92 +19,150 @@ void Bomb::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_explosion_time"), &Bomb::get_explosion_time);
 	ClassDB::bind_method(D_METHOD("set_flame_range", "range"), &Bomb::set_flame_range);
 	ClassDB::bind_method(D_METHOD("get_flame_range"), &Bomb::get_flame_range);
-	ClassDB::bind_method(D_METHOD("set_owner_path", "path"), &Bomb::set_owner_path);
-	ClassDB::bind_method(D_METHOD("get_owner_path"), &Bomb::get_owner_path);
-	ClassDB::bind_method(D_METHOD("set_grid_manager_path", "path"), &Bomb::set_grid_manager_path);
-	ClassDB::bind_method(D_METHOD("get_grid_manager_path"), &Bomb::get_grid_manager_path);
+	ClassDB::bind_method(D_METHOD("set_owner_handle", "handle"), &Bomb::set_owner_handle);
+	ClassDB::bind_method(D_METHOD("get_owner_handle"), &Bomb::get_owner_handle);
+	ClassDB::bind_method(D_METHOD("set_grid_manager_handle", "handle"), &Bomb::set_grid_manager_handle);
+	ClassDB::bind_method(D_METHOD("get_grid_manager_handle"), &Bomb::get_grid_manager_handle);
 	ClassDB::bind_method(D_METHOD("get_has_exploded"), &Bomb::get_has_exploded);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_x"), "set_grid_x", "get_grid_x");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_y"), "set_grid_y", "get_grid_y");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "explosion_time"), "set_explosion_time", "get_explosion_time");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "flame_range"), "set_flame_range", "get_flame_range");
-	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "owner_path"), "set_owner_path", "get_owner_path");
-	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "grid_manager_path"), "set_grid_manager_path", "get_grid_manager_path");
+	// Handles are runtime-only; not stored in scenes.
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "owner_handle", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_owner_handle", "get_owner_handle");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_manager_handle", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_grid_manager_handle", "get_grid_manager_handle");
 
 	ADD_SIGNAL(MethodInfo("exploded", PropertyInfo(Variant::INT, "grid_x"), PropertyInfo(Variant::INT, "grid_y"), PropertyInfo(Variant::ARRAY, "tiles")));
 }
 
-Bomb::Bomb() {}
+Bomb::Bomb() {
+	// The registry record is created on the main thread on first use (see _register).
+}
 
-Bomb::~Bomb() {}
+Bomb::~Bomb() {
+	EntityRegistry::release(entity_handle);
+}
 
-void Bomb::_ready() {
-	if (!grid_manager_path.is_empty()) {
-		grid_manager = get_node<GridManager>(grid_manager_path);
-	}
+bool Bomb::_register() {
+	if (entity_handle != INVALID_ENTITY_HANDLE) return true;
+	if (!EntityRegistry::is_main_thread()) return false;
+	BombState state = unregistered_state;
+	state.node = this;
+	entity_handle = EntityRegistry::get_singleton()->bombs.create(state);
+	return true;
+}
+
+BombState &Bomb::_state() {
+	// Until registered (built off the main thread, not used there yet) state lives in the node.
+	if (!_register()) return unregistered_state;
+	BombState *state = EntityRegistry::get_singleton()->bombs.get(entity_handle);
+	CRASH_COND_MSG(!state, "Bomb has no registry record (stale entity handle).");
+	return *state;
+}
+
+const BombState &Bomb::_state() const {
+	return const_cast<Bomb *>(this)->_state();
+}
+
+void Bomb::_enter_tree() {
+	_register();
+}
+
+EntityHandle Bomb::get_entity_handle() const {
+	const_cast<Bomb *>(this)->_register();
+	return entity_handle;
 }
 
-void Bomb::_collect_direction(Array &out, int dx, int dy) const {
-	if (!grid_manager) return;
-	for (int d = 1; d <= flame_range; d++) {
-		int tx = grid_x + dx * d;
-		int ty = grid_y + dy * d;
-		if (grid_manager->get_tile(tx, ty) == GridManager::TILE_WALL) break;
-		out.append(Vector2i(tx, ty));
-		if (grid_manager->is_tile_destructible(tx, ty)) break;
+void Bomb::_collect_explosion_cells(bomberman::FrameVector<Vector2i> &out) const {
+	const BombState &state = _state();
+	GridManager *grid_manager = EntityRegistry::get_singleton()->get_grid_manager(state.grid_manager);
+	if (!grid_manager) {
+		out.push_back(Vector2i(state.grid_x, state.grid_y));
+		return;
 	}
+	// flame_range is unchecked script input; the grid bounds the reservation.
+	const bomberman::GridState &grid = grid_manager->get_grid_state();
+	out.reserve(bomberman::max_blast_cells(state.flame_range, grid.get_width(), grid.get_height()));
+	bomberman::collect_blast_cells(grid, state.grid_x, state.grid_y, state.flame_range, [&out](int x, int y) {
+		out.push_back(Vector2i(x, y));
+	});
 }
 
-Array Bomb::get_explosion_tiles() const {
+Array Bomb::_to_array(const bomberman::FrameVector<Vector2i> &p_cells) {
+	// Leaves the frame (GDScript may keep it), so this one goes through Godot's allocator.
 	Array tiles;
-	tiles.append(Vector2i(grid_x, grid_y));
-	_collect_direction(tiles, 1, 0);
-	_collect_direction(tiles, -1, 0);
-	_collect_direction(tiles, 0, 1);
-	_collect_direction(tiles, 0, -1);
+	tiles.resize((int64_t)p_cells.size());
+	for (size_t i = 0; i < p_cells.size(); i++) {
+		tiles[(int64_t)i] = p_cells[i];
+	}
 	return tiles;
 }
 
+Array Bomb::get_explosion_tiles() const {
+	bomberman::FrameVector<Vector2i> cells;
+	_collect_explosion_cells(cells);
+	return _to_array(cells);
+}
+
 void Bomb::_process(double delta) {
-	if (has_exploded) return;
-	timer += delta;
-	if (timer >= explosion_time) {
+	BombState &state = _state();
+	if (state.has_exploded) return;
+	state.timer += delta;
+	if (state.timer >= state.explosion_time) {
 		explode();
 	}
 }
 
 void Bomb::explode() {
-	if (has_exploded) return;
-	has_exploded = true;
-	Array tiles = get_explosion_tiles();
+	EntityRegistry *registry = EntityRegistry::get_singleton();
+	BombState &state = _state();
+	if (state.has_exploded) return;
+	state.has_exploded = true;
+	bomberman::FrameVector<Vector2i> cells;
+	_collect_explosion_cells(cells);
+	GridManager *grid_manager = registry->get_grid_manager(state.grid_manager);
 	if (grid_manager) {
-		for (int i = 0; i < tiles.size(); i++) {
-			Variant v = tiles[i];
-			if (v.get_type() == Variant::VECTOR2I) {
-				Vector2i p = v;
-				if (grid_manager->is_tile_destructible(p.x, p.y)) {
-					grid_manager->destroy_tile(p.x, p.y);
-				}
-			}
+		for (const Vector2i &p : cells) {
+			grid_manager->destroy_tile(p.x, p.y);
 		}
 	}
-	emit_signal("exploded", grid_x, grid_y, tiles);
+	// Kill players on this grid standing in the blast; signal only after the pool walk so
+	// "died" handlers cannot change the pool under it.
+	bomberman::FrameVector<EntityHandle> killed;
+	for (size_t i = 0; i < registry->players.size(); i++) {
+		PlayerState &player_state = registry->players.at(i);
+		if (player_state.grid_manager == _state().grid_manager && bomberman::catch_in_blast(player_state, cells)) {
+			killed.push_back(registry->players.handle_at(i));
+		}
+	}
+	for (EntityHandle handle : killed) {
+		Player *player = registry->get_player(handle);
+		if (player) {
+			player->emit_signal("died");
+		}
+	}
+	// Return the bomb slot to its owner; a stale handle (owner freed) is simply ignored.
+	Player *owner_player = registry->get_player(_state().owner);
+	if (owner_player) {
+		owner_player->on_bomb_exploded();
+	}
+	emit_signal("exploded", _state().grid_x, _state().grid_y, _to_array(cells));
 }
 
-void Bomb::set_grid_x(int x) { grid_x = x; }
-int Bomb::get_grid_x() const { return grid_x; }
-void Bomb::set_grid_y(int y) { grid_y = y; }
-int Bomb::get_grid_y() const { return grid_y; }
-void Bomb::set_grid_position(int x, int y) { grid_x = x; grid_y = y; }
-void Bomb::set_explosion_time(double p_time) { explosion_time = p_time; }
-double Bomb::get_explosion_time() const { return explosion_time; }
-void Bomb::set_flame_range(int p_range) { flame_range = p_range; }
-int Bomb::get_flame_range() const { return flame_range; }
-void Bomb::set_owner_path(const NodePath &p_path) { owner_path = p_path; }
-NodePath Bomb::get_owner_path() const { return owner_path; }
-void Bomb::set_grid_manager_path(const NodePath &p_path) { grid_manager_path = p_path; }
-NodePath Bomb::get_grid_manager_path() const { return grid_manager_path; }
-bool Bomb::get_has_exploded() const { return has_exploded; }
+void Bomb::set_grid_x(int x) { _state().grid_x = x; }
+int Bomb::get_grid_x() const { return _state().grid_x; }
+void Bomb::set_grid_y(int y) { _state().grid_y = y; }
+int Bomb::get_grid_y() const { return _state().grid_y; }
+void Bomb::set_grid_position(int x, int y) { _state().grid_x = x; _state().grid_y = y; }
+void Bomb::set_explosion_time(double p_time) { _state().explosion_time = p_time; }
+double Bomb::get_explosion_time() const { return _state().explosion_time; }
+void Bomb::set_flame_range(int p_range) { _state().flame_range = p_range; }
+int Bomb::get_flame_range() const { return _state().flame_range; }
+void Bomb::set_owner_handle(EntityHandle p_handle) { _state().owner = p_handle; }
+EntityHandle Bomb::get_owner_handle() const { return _state().owner; }
+void Bomb::set_grid_manager_handle(EntityHandle p_handle) { _state().grid_manager = p_handle; }
+EntityHandle Bomb::get_grid_manager_handle() const { return _state().grid_manager; }
+bool Bomb::get_has_exploded() const { return _state().has_exploded; }
 
 } // namespace godot
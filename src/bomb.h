@@ -1,6 +1,9 @@
 #ifndef BOMBERMAN_BOMB_H
 #define BOMBERMAN_BOMB_H
 
+#include "entity_registry.h"
+#include "frame_arena.h"
+
 #include <godot_cpp/classes/node2d.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
@@ -11,24 +14,25 @@ class GridManager;
 
 /**
  * Bomb placed by a player. Counts down, computes explosion tiles,
- * destroys destructible tiles via GridManager, then emits exploded with tile list.
+ * destroys destructible tiles via GridManager, kills players caught in the blast,
+ * then emits exploded with tile list. Rules come from game_rules.h.
+ * Owner and grid are registry handles (no NodePath work when a bomb is spawned).
  */
 class Bomb : public Node2D {
 	GDCLASS(Bomb, Node2D)
 
 private:
-	int grid_x = 0;
-	int grid_y = 0;
-	double timer = 0.0;
-	double explosion_time = 2.0;
-	int flame_range = 1;
-	NodePath owner_path;
-	NodePath grid_manager_path;
-	GridManager *grid_manager = nullptr;
-	bool has_exploded = false;
-
-	/** Collect tiles in one direction (dx,dy); stop at wall, include destructible then stop. */
-	void _collect_direction(Array &out, int dx, int dy) const;
+	EntityHandle entity_handle = INVALID_ENTITY_HANDLE;
+	BombState unregistered_state;
+
+	BombState &_state();
+	const BombState &_state() const;
+	/** Creates the registry record from unregistered_state; false (no-op) off the main thread. */
+	bool _register();
+
+	/** All explosion cells, in per-frame scratch memory. */
+	void _collect_explosion_cells(bomberman::FrameVector<Vector2i> &out) const;
+	static Array _to_array(const bomberman::FrameVector<Vector2i> &p_cells);
 
 protected:
 	static void _bind_methods();
@@ -37,9 +41,11 @@ public:
 	Bomb();
 	~Bomb();
 
-	void _ready() override;
+	void _enter_tree() override;
 	void _process(double delta) override;
 
+	EntityHandle get_entity_handle() const;
+
 	void explode();
 	/** Returns Array of Vector2i: all grid cells affected by explosion (for damage/visuals). */
 	Array get_explosion_tiles() const;
@@ -53,10 +59,10 @@ public:
 	double get_explosion_time() const;
 	void set_flame_range(int p_range);
 	int get_flame_range() const;
-	void set_owner_path(const NodePath &p_path);
-	NodePath get_owner_path() const;
-	void set_grid_manager_path(const NodePath &p_path);
-	NodePath get_grid_manager_path() const;
+	void set_owner_handle(EntityHandle p_handle);
+	EntityHandle get_owner_handle() const;
+	void set_grid_manager_handle(EntityHandle p_handle);
+	EntityHandle get_grid_manager_handle() const;
 	bool get_has_exploded() const;
 };
 
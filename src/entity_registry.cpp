@@ -0,0 +1,75 @@
+#include "entity_registry.h"
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+namespace godot {
+
+EntityRegistry::EntityRegistry() :
+		grid_managers(ENTITY_KIND_GRID_MANAGER),
+		players(ENTITY_KIND_PLAYER),
+		bombs(ENTITY_KIND_BOMB),
+		power_ups(ENTITY_KIND_POWER_UP) {}
+
+EntityRegistry *EntityRegistry::get_singleton() {
+	// Function-local static: exists before the first node is constructed, outlives the last one.
+	static EntityRegistry singleton;
+	return &singleton;
+}
+
+bool EntityRegistry::is_main_thread() {
+	OS *os = OS::get_singleton();
+	return !os || os->get_thread_caller_id() == os->get_main_thread_id();
+}
+
+void EntityRegistry::release(EntityHandle p_handle) {
+	if (p_handle == INVALID_ENTITY_HANDLE) return;
+	if (is_main_thread()) {
+		_release_now(p_handle);
+	} else {
+		// The message queue is thread-safe; the record goes away on the next flush.
+		callable_mp_static(&EntityRegistry::_release_now).call_deferred(p_handle);
+	}
+}
+
+void EntityRegistry::_release_now(EntityHandle p_handle) {
+	EntityRegistry *registry = get_singleton();
+	switch (entity_kind_of(p_handle)) {
+		case ENTITY_KIND_GRID_MANAGER:
+			registry->grid_managers.destroy(p_handle);
+			break;
+		case ENTITY_KIND_PLAYER:
+			registry->players.destroy(p_handle);
+			break;
+		case ENTITY_KIND_BOMB:
+			registry->bombs.destroy(p_handle);
+			break;
+		case ENTITY_KIND_POWER_UP:
+			registry->power_ups.destroy(p_handle);
+			break;
+		default:
+			break;
+	}
+}
+
+GridManager *EntityRegistry::get_grid_manager(EntityHandle p_handle) const {
+	GridManager *const *gm = grid_managers.get(p_handle);
+	return gm ? *gm : nullptr;
+}
+
+Player *EntityRegistry::get_player(EntityHandle p_handle) const {
+	const PlayerState *state = players.get(p_handle);
+	return state ? state->node : nullptr;
+}
+
+Bomb *EntityRegistry::get_bomb(EntityHandle p_handle) const {
+	const BombState *state = bombs.get(p_handle);
+	return state ? state->node : nullptr;
+}
+
+PowerUp *EntityRegistry::get_power_up(EntityHandle p_handle) const {
+	const PowerUpState *state = power_ups.get(p_handle);
+	return state ? state->node : nullptr;
+}
+
+} // namespace godot
@@ -0,0 +1,210 @@
+#ifndef BOMBERMAN_ENTITY_REGISTRY_H
+#define BOMBERMAN_ENTITY_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+class GridManager;
+class Player;
+class Bomb;
+class PowerUp;
+
+/**
+ * Generational entity handle, exposed to GDScript as a plain int.
+ * Bits 0-31: slot index, bits 32-55: generation, bits 56-63: entity kind.
+ * Handle 0 is never issued; a handle becomes stale once its entity is destroyed.
+ */
+typedef int64_t EntityHandle;
+
+static constexpr EntityHandle INVALID_ENTITY_HANDLE = 0;
+
+enum EntityKind : uint8_t {
+	ENTITY_KIND_NONE = 0,
+	ENTITY_KIND_GRID_MANAGER = 1,
+	ENTITY_KIND_PLAYER = 2,
+	ENTITY_KIND_BOMB = 3,
+	ENTITY_KIND_POWER_UP = 4,
+};
+
+/** Gameplay state of a Player node; the node reads and writes it through its handle. */
+struct PlayerState {
+	Player *node = nullptr;
+	EntityHandle grid_manager = INVALID_ENTITY_HANDLE;
+	int grid_x = 0;
+	int grid_y = 0;
+	double move_speed = 3.0; // tiles per second
+	int bomb_capacity = 1;
+	int active_bombs = 0;
+	int flame_range = 1;
+	bool is_alive = true;
+};
+
+/** Gameplay state of a Bomb node. owner and grid_manager are handles, never paths. */
+struct BombState {
+	Bomb *node = nullptr;
+	EntityHandle owner = INVALID_ENTITY_HANDLE;
+	EntityHandle grid_manager = INVALID_ENTITY_HANDLE;
+	int grid_x = 0;
+	int grid_y = 0;
+	double timer = 0.0;
+	double explosion_time = 2.0;
+	int flame_range = 1;
+	bool has_exploded = false;
+};
+
+/** Gameplay state of a PowerUp node. */
+struct PowerUpState {
+	PowerUp *node = nullptr;
+	int type = 0;
+	int grid_x = 0;
+	int grid_y = 0;
+};
+
+/**
+ * Dense pool of T addressed by generational handles.
+ * Values are packed contiguously (swap-and-pop on destroy), so pointers returned by get()
+ * are only valid until the next create()/destroy() on the same pool.
+ */
+template <typename T>
+class EntityPool {
+private:
+	struct Slot {
+		uint32_t generation = 1;
+		uint32_t dense_index = 0;
+		bool alive = false;
+	};
+
+	static constexpr uint32_t GENERATION_MASK = 0xFFFFFF;
+
+	EntityKind kind;
+	std::vector<Slot> slots;
+	std::vector<uint32_t> free_slots;
+	std::vector<T> dense;
+	std::vector<uint32_t> dense_to_slot;
+
+	const Slot *_resolve(EntityHandle p_handle) const {
+		if (p_handle <= 0) return nullptr;
+		uint64_t bits = (uint64_t)p_handle;
+		if ((EntityKind)(bits >> 56) != kind) return nullptr;
+		uint32_t index = (uint32_t)(bits & 0xFFFFFFFFu);
+		uint32_t generation = (uint32_t)((bits >> 32) & GENERATION_MASK);
+		if (index >= slots.size()) return nullptr;
+		const Slot &slot = slots[index];
+		if (!slot.alive || slot.generation != generation) return nullptr;
+		return &slot;
+	}
+
+	EntityHandle _make_handle(uint32_t p_index) const {
+		uint64_t bits = ((uint64_t)kind << 56) | ((uint64_t)(slots[p_index].generation & GENERATION_MASK) << 32) | p_index;
+		return (EntityHandle)bits;
+	}
+
+public:
+	explicit EntityPool(EntityKind p_kind) :
+			kind(p_kind) {}
+
+	EntityHandle create(const T &p_value) {
+		uint32_t index;
+		if (!free_slots.empty()) {
+			index = free_slots.back();
+			free_slots.pop_back();
+		} else {
+			index = (uint32_t)slots.size();
+			slots.push_back(Slot());
+		}
+		Slot &slot = slots[index];
+		slot.alive = true;
+		slot.dense_index = (uint32_t)dense.size();
+		dense.push_back(p_value);
+		dense_to_slot.push_back(index);
+		return _make_handle(index);
+	}
+
+	/** Frees the entity; returns false if the handle was already stale. */
+	bool destroy(EntityHandle p_handle) {
+		const Slot *found = _resolve(p_handle);
+		if (!found) return false;
+		uint32_t index = (uint32_t)(found - slots.data());
+		Slot &slot = slots[index];
+		uint32_t last = (uint32_t)dense.size() - 1;
+		if (slot.dense_index != last) {
+			dense[slot.dense_index] = dense[last];
+			dense_to_slot[slot.dense_index] = dense_to_slot[last];
+			slots[dense_to_slot[slot.dense_index]].dense_index = slot.dense_index;
+		}
+		dense.pop_back();
+		dense_to_slot.pop_back();
+		slot.alive = false;
+		// Skip generation 0 on wrap so a recycled slot never reproduces an old handle of generation 0.
+		slot.generation = (slot.generation + 1) & GENERATION_MASK;
+		if (slot.generation == 0) slot.generation = 1;
+		free_slots.push_back(index);
+		return true;
+	}
+
+	bool is_valid(EntityHandle p_handle) const {
+		return _resolve(p_handle) != nullptr;
+	}
+
+	/** Returns nullptr for stale, foreign-kind or invalid handles. */
+	T *get(EntityHandle p_handle) {
+		const Slot *slot = _resolve(p_handle);
+		return slot ? &dense[slot->dense_index] : nullptr;
+	}
+
+	const T *get(EntityHandle p_handle) const {
+		const Slot *slot = _resolve(p_handle);
+		return slot ? &dense[slot->dense_index] : nullptr;
+	}
+
+	// Dense iteration for systems that sweep every entity of a kind.
+	size_t size() const { return dense.size(); }
+	T &at(size_t p_dense_index) { return dense[p_dense_index]; }
+	const T &at(size_t p_dense_index) const { return dense[p_dense_index]; }
+	EntityHandle handle_at(size_t p_dense_index) const { return _make_handle(dense_to_slot[p_dense_index]); }
+};
+
+/** Kind encoded in p_handle (ENTITY_KIND_NONE for 0 and negative values). */
+inline EntityKind entity_kind_of(EntityHandle p_handle) {
+	return p_handle > 0 ? (EntityKind)((uint64_t)p_handle >> 56) : ENTITY_KIND_NONE;
+}
+
+/**
+ * Process-wide registry of gameplay entities. Other systems resolve owners and grid managers
+ * by handle in O(1) instead of walking NodePaths.
+ *
+ * The pools are unguarded and only touched on the main thread. A node built elsewhere
+ * (e.g. PackedScene.instantiate() on a worker) keeps its state in the node and registers it
+ * the first time it is used on the main thread, at the latest when it enters the tree.
+ * Records are released with release(), which defers to the main thread when needed.
+ */
+class EntityRegistry {
+private:
+	EntityRegistry();
+
+	static void _release_now(EntityHandle p_handle);
+
+public:
+	EntityPool<GridManager *> grid_managers;
+	EntityPool<PlayerState> players;
+	EntityPool<BombState> bombs;
+	EntityPool<PowerUpState> power_ups;
+
+	static EntityRegistry *get_singleton();
+	/** True on the engine's main thread (or before the OS singleton exists). */
+	static bool is_main_thread();
+	/** Frees p_handle's record, whatever its kind; from another thread the free is deferred to the main thread. */
+	static void release(EntityHandle p_handle);
+
+	GridManager *get_grid_manager(EntityHandle p_handle) const;
+	Player *get_player(EntityHandle p_handle) const;
+	Bomb *get_bomb(EntityHandle p_handle) const;
+	PowerUp *get_power_up(EntityHandle p_handle) const;
+};
+
+} // namespace godot
+
+#endif // BOMBERMAN_ENTITY_REGISTRY_H
@@ -0,0 +1,56 @@
+#include "frame_arena.h"
+
+#include <cstdio>
+#include <thread>
+
+namespace bomberman {
+
+static FrameArena::ErrorHandler error_handler = nullptr;
+static FrameArena::FrameCounter frame_counter = nullptr;
+static std::thread::id frame_counter_thread;
+static uint64_t frame_counter_last = 0; // only touched on frame_counter_thread
+
+static Arena &thread_arena() {
+	// 16 KiB covers a frame of explosions and a map load; reset() grows it if a frame needs more.
+	static thread_local Arena arena(16 * 1024);
+	return arena;
+}
+
+Arena &FrameArena::get() {
+	Arena &arena = thread_arena();
+	if (frame_counter && std::this_thread::get_id() == frame_counter_thread) {
+		uint64_t frame = frame_counter();
+		if (frame != frame_counter_last) {
+			// Anything still allocated belongs to an earlier frame: nobody called end_frame().
+			frame_counter_last = frame;
+			if (arena.get_bytes_used() > 0) arena.reset();
+		}
+	}
+	return arena;
+}
+
+void FrameArena::end_frame() {
+	thread_arena().reset();
+}
+
+void FrameArena::set_frame_counter(FrameCounter p_counter) {
+	frame_counter = p_counter;
+	frame_counter_thread = std::this_thread::get_id();
+	frame_counter_last = p_counter ? p_counter() : 0;
+}
+
+void FrameArena::set_error_handler(ErrorHandler p_handler) {
+	error_handler = p_handler;
+}
+
+void FrameArena::report_error(const char *p_operation) {
+	char message[128];
+	std::snprintf(message, sizeof(message), "Frame arena memory escaped its frame (%s after reset).", p_operation);
+	if (error_handler) {
+		error_handler(message);
+	} else {
+		std::fprintf(stderr, "%s\n", message);
+	}
+}
+
+} // namespace bomberman
@@ -0,0 +1,89 @@
+#ifndef BOMBERMAN_FRAME_ARENA_H
+#define BOMBERMAN_FRAME_ARENA_H
+
+#include "arena.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace bomberman {
+
+/**
+ * Per-thread scratch arena for buffers that live within one tick (explosion cell lists,
+ * map text, queues). The main thread's arena is reset by the FrameArenaClock autoload after
+ * every physics tick and idle frame; worker threads call end_frame() at the end of their own tick.
+ *
+ * As a fallback for projects without the autoload, the thread that installs a frame counter
+ * (the extension installs the engine's) also resets lazily: the first get() after the counter
+ * changes starts a new frame.
+ */
+class FrameArena {
+public:
+	typedef void (*ErrorHandler)(const char *p_message);
+	typedef uint64_t (*FrameCounter)();
+
+	/** Scratch arena of the calling thread. */
+	static Arena &get();
+	/** Releases everything the calling thread allocated this frame. */
+	static void end_frame();
+
+	/** Where escape-guard failures are reported (the extension routes them to ERR_PRINT). */
+	static void set_error_handler(ErrorHandler p_handler);
+	/** Installs the lazy-reset counter for the calling thread only; nullptr removes it. */
+	static void set_frame_counter(FrameCounter p_counter);
+	static void report_error(const char *p_operation);
+};
+
+/**
+ * Allocator over the calling thread's FrameArena. With DEBUG_ENABLED it remembers the frame
+ * it was created in and reports any allocate/deallocate after that frame has been reset,
+ * i.e. a container that escaped its frame.
+ */
+template <typename T>
+class FrameAllocator {
+public:
+	typedef T value_type;
+
+	Arena *arena;
+	uint64_t frame_index;
+
+	FrameAllocator() :
+			arena(&FrameArena::get()),
+			frame_index(arena->get_frame_index()) {}
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U> &p_other) :
+			arena(p_other.arena),
+			frame_index(p_other.frame_index) {}
+
+	T *allocate(size_t n) {
+		_check_frame("allocate");
+		return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T *, size_t) {
+		_check_frame("deallocate");
+	}
+
+	void _check_frame(const char *p_operation) const {
+#ifdef DEBUG_ENABLED
+		if (arena->get_frame_index() != frame_index) {
+			FrameArena::report_error(p_operation);
+		}
+#else
+		(void)p_operation;
+#endif
+	}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U> &p_other) const { return arena == p_other.arena; }
+	template <typename U>
+	bool operator!=(const FrameAllocator<U> &p_other) const { return arena != p_other.arena; }
+};
+
+/** Vector whose storage is released at the end of the frame; never keep one across ticks. */
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_FRAME_ARENA_H
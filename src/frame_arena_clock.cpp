@@ -0,0 +1,39 @@
+#include "frame_arena_clock.h"
+#include "frame_arena.h"
+#include <godot_cpp/core/class_db.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+void FrameArenaClock::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_frame_arena_stats"), &FrameArenaClock::get_frame_arena_stats);
+}
+
+FrameArenaClock::FrameArenaClock() {
+	// Last in both passes, so the reset really is the end of the tick.
+	set_physics_process_priority(INT32_MAX);
+	set_process_priority(INT32_MAX);
+	set_process_mode(PROCESS_MODE_ALWAYS);
+}
+
+void FrameArenaClock::_physics_process(double delta) {
+	bomberman::FrameArena::end_frame();
+}
+
+void FrameArenaClock::_process(double delta) {
+	bomberman::FrameArena::end_frame();
+}
+
+Dictionary FrameArenaClock::get_frame_arena_stats() const {
+	const bomberman::Arena &arena = bomberman::FrameArena::get();
+	Dictionary stats;
+	stats["bytes_used"] = (int64_t)arena.get_bytes_used();
+	stats["peak_bytes_used"] = (int64_t)arena.get_peak_bytes_used();
+	stats["bytes_reserved"] = (int64_t)arena.get_bytes_reserved();
+	stats["chunk_allocations"] = (int64_t)arena.get_chunk_allocations();
+	stats["frame_index"] = (int64_t)arena.get_frame_index();
+	return stats;
+}
+
+} // namespace godot
@@ -0,0 +1,34 @@
+#ifndef BOMBERMAN_FRAME_ARENA_CLOCK_H
+#define BOMBERMAN_FRAME_ARENA_CLOCK_H
+
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+namespace godot {
+
+/**
+ * Ends the main thread's FrameArena frame after every physics tick and every idle frame.
+ * Autoloaded once per project (res://autoload/frame_arena_clock.tscn) so resets do not depend
+ * on which gameplay nodes a scene contains. Runs with the highest process priorities, i.e.
+ * after every other node, and keeps running while the tree is paused. Projects without it
+ * still get a reset on the first arena use of each new engine frame (FrameArena::set_frame_counter).
+ */
+class FrameArenaClock : public Node {
+	GDCLASS(FrameArenaClock, Node)
+
+protected:
+	static void _bind_methods();
+
+public:
+	FrameArenaClock();
+
+	void _physics_process(double delta) override;
+	void _process(double delta) override;
+
+	/** Debug stats of the main thread's FrameArena: bytes_used, peak_bytes_used, bytes_reserved, chunk_allocations, frame_index. */
+	Dictionary get_frame_arena_stats() const;
+};
+
+} // namespace godot
+
+#endif // BOMBERMAN_FRAME_ARENA_CLOCK_H
@@ -0,0 +1,112 @@
+#ifndef BOMBERMAN_GAME_RULES_H
+#define BOMBERMAN_GAME_RULES_H
+
+#include "grid_state.h"
+
+#include <cstddef>
+
+namespace bomberman {
+
+/**
+ * Engine-independent gameplay rules shared by the Player/Bomb nodes and the headless server.
+ * Player types need grid_x, grid_y, bomb_capacity, active_bombs, flame_range and is_alive
+ * (PlayerState, Room::RoomPlayer); Grid is any BasicGridState.
+ *
+ * An explosion resolves in this order, on the grid as it was when the bomb went off:
+ * collect_blast_cells, destroy every cell's tile, catch_in_blast for each player, then
+ * release_bomb on the owner.
+ */
+
+// Power-up caps.
+static constexpr int MAX_FLAME_RANGE = 5;
+static constexpr int MAX_BOMB_CAPACITY = 5;
+
+/**
+ * Upper bound on collect_blast_cells output on a p_width x p_height grid: the centre plus
+ * four arms of at most p_flame_range cells. Arms stop at the grid edge and opposite arms share
+ * a row or column, so the grid also bounds it; any flame range is safe to reserve for.
+ */
+inline size_t max_blast_cells(int p_flame_range, int p_width, int p_height) {
+	size_t range = p_flame_range > 0 ? (size_t)p_flame_range : 0;
+	size_t grid_cells = (size_t)(p_width > 0 ? p_width : 0) + (size_t)(p_height > 0 ? p_height : 0);
+	size_t arms = 4 * range < 2 * grid_cells ? 4 * range : 2 * grid_cells;
+	return 1 + arms;
+}
+
+/** Moves p_player by (dx, dy) onto a walkable cell. Dead players do not move. */
+template <typename Player, typename Grid>
+bool try_move(Player &p_player, const Grid &p_grid, int dx, int dy) {
+	if (!p_player.is_alive) return false;
+	int nx = p_player.grid_x + dx;
+	int ny = p_player.grid_y + dy;
+	if (!p_grid.is_walkable(nx, ny)) return false;
+	p_player.grid_x = nx;
+	p_player.grid_y = ny;
+	return true;
+}
+
+template <typename Player>
+bool can_place_bomb(const Player &p_player) {
+	return p_player.is_alive && p_player.active_bombs < p_player.bomb_capacity;
+}
+
+/** Takes a bomb slot; returns false (and changes nothing) if the player cannot place one. */
+template <typename Player>
+bool place_bomb(Player &p_player) {
+	if (!can_place_bomb(p_player)) return false;
+	p_player.active_bombs++;
+	return true;
+}
+
+/** Gives the slot of an exploded bomb back to its owner. */
+template <typename Player>
+void release_bomb(Player &p_player) {
+	if (p_player.active_bombs > 0) p_player.active_bombs--;
+}
+
+/** Any power-up raises flame range first, then bomb capacity, each up to its cap. */
+template <typename Player>
+void apply_power_up(Player &p_player) {
+	if (p_player.flame_range < MAX_FLAME_RANGE) {
+		p_player.flame_range++;
+	} else if (p_player.bomb_capacity < MAX_BOMB_CAPACITY) {
+		p_player.bomb_capacity++;
+	}
+}
+
+/**
+ * Calls p_emit(x, y) for every cell a bomb at (x, y) with p_flame_range hits: the bomb's own
+ * cell, then east, west, south and north arms as far as blast_extent allows.
+ */
+template <typename Grid, typename Emit>
+void collect_blast_cells(const Grid &p_grid, int x, int y, int p_flame_range, Emit p_emit) {
+	p_emit(x, y);
+	for (int dir = 0; dir < BLAST_DIRECTION_COUNT; dir++) {
+		int dx = BLAST_DIR_DX[dir];
+		int dy = BLAST_DIR_DY[dir];
+		int reach = p_grid.blast_extent(x, y, dx, dy, p_flame_range);
+		for (int d = 1; d <= reach; d++) {
+			p_emit(x + dx * d, y + dy * d);
+		}
+	}
+}
+
+/**
+ * Kills p_player if it stands on one of p_cells (anything with .x/.y members).
+ * Returns true only when this call killed it.
+ */
+template <typename Player, typename Cells>
+bool catch_in_blast(Player &p_player, const Cells &p_cells) {
+	if (!p_player.is_alive) return false;
+	for (const auto &c : p_cells) {
+		if (c.x == p_player.grid_x && c.y == p_player.grid_y) {
+			p_player.is_alive = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_GAME_RULES_H
@@ -1,13 +1,12 @@
 #include "grid_manager.h"
+#include "frame_arena.h"
 #include <godot_cpp/core/class_db.hpp>
 
 namespace godot {
 
-int GridManager::_tile_index(int x, int y) const {
-	return y * grid_width + x;
-}
-
 void GridManager::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_entity_handle"), &GridManager::get_entity_handle);
+
 	ClassDB::bind_method(D_METHOD("set_grid_width", "width"), &GridManager::set_grid_width);
 	ClassDB::bind_method(D_METHOD("get_grid_width"), &GridManager::get_grid_width);
 	ClassDB::bind_method(D_METHOD("set_grid_height", "height"), &GridManager::set_grid_height);
@@ -25,6 +24,7 @@ void GridManager::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_tile", "x", "y", "type"), &GridManager::set_tile);
 	ClassDB::bind_method(D_METHOD("get_tile", "x", "y"), &GridManager::get_tile);
 	ClassDB::bind_method(D_METHOD("destroy_tile", "x", "y"), &GridManager::destroy_tile);
+	ClassDB::bind_method(D_METHOD("get_blast_extent", "x", "y", "dx", "dy", "range"), &GridManager::get_blast_extent);
 	ClassDB::bind_method(D_METHOD("load_map_from_string", "map_data"), &GridManager::load_map_from_string);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_width"), "set_grid_width", "get_grid_width");
@@ -40,30 +40,53 @@ void GridManager::_bind_methods() {
 	ClassDB::bind_integer_constant(get_class_static(), "TileType", "TILE_DESTRUCTIBLE", TILE_DESTRUCTIBLE);
 }
 
-GridManager::GridManager() {
-	tiles.resize((size_t)(grid_width * grid_height), TILE_FLOOR);
+GridManager::GridManager() :
+		grid(15, 13) {
+	// Registered on the main thread on first use (see _register).
+}
+
+GridManager::~GridManager() {
+	EntityRegistry::release(entity_handle);
+}
+
+bool GridManager::_register() {
+	if (entity_handle != INVALID_ENTITY_HANDLE) return true;
+	if (!EntityRegistry::is_main_thread()) return false;
+	entity_handle = EntityRegistry::get_singleton()->grid_managers.create(this);
+	return true;
+}
+
+void GridManager::_enter_tree() {
+	_register();
+}
+
+EntityHandle GridManager::get_entity_handle() const {
+	const_cast<GridManager *>(this)->_register();
+	return entity_handle;
+}
+
+const bomberman::GridState &GridManager::get_grid_state() const {
+	return grid;
 }
 
-GridManager::~GridManager() {}
+void GridManager::assign_tiles(int p_width, int p_height, const uint8_t *p_tiles) {
+	grid.assign(p_width, p_height, p_tiles);
+}
 
 void GridManager::set_grid_width(int p_width) {
-	if (p_width <= 0) return;
-	grid_width = p_width;
-	tiles.resize((size_t)(grid_width * grid_height), TILE_FLOOR);
+	grid.resize(p_width, grid.get_height());
 }
 
 int GridManager::get_grid_width() const {
-	return grid_width;
+	return grid.get_width();
 }
 
 void GridManager::set_grid_height(int p_height) {
-	if (p_height <= 0) return;
-	grid_height = p_height;
-	tiles.resize((size_t)(grid_width * grid_height), TILE_FLOOR);
+	grid.resize(grid.get_width(), p_height);
 }
 
 int GridManager::get_grid_height() const {
-	return grid_height;
+	return grid.get_height();
 }
 
 void GridManager::set_tile_size(int p_size) {
@@ -99,47 +122,43 @@ Vector2i GridManager::world_to_grid(const Vector2 &world_pos) const {
 }
 
 bool GridManager::is_tile_walkable(int x, int y) const {
-	if (x < 0 || x >= grid_width || y < 0 || y >= grid_height) return false;
-	return get_tile(x, y) == TILE_FLOOR;
+	return grid.is_walkable(x, y);
 }
 
 bool GridManager::is_tile_destructible(int x, int y) const {
-	if (x < 0 || x >= grid_width || y < 0 || y >= grid_height) return false;
-	return get_tile(x, y) == TILE_DESTRUCTIBLE;
+	return grid.is_destructible(x, y);
 }
 
 void GridManager::set_tile(int x, int y, int p_type) {
-	if (x < 0 || x >= grid_width || y < 0 || y >= grid_height) return;
-	tiles[(size_t)_tile_index(x, y)] = p_type;
+	// Tiles are stored as bytes; anything outside TileType would be silently narrowed.
+	ERR_FAIL_COND_MSG(p_type < TILE_FLOOR || p_type > TILE_DESTRUCTIBLE, "Tile type must be a GridManager.TileType value.");
+	grid.set_tile(x, y, p_type);
 }
 
 int GridManager::get_tile(int x, int y) const {
-	if (x < 0 || x >= grid_width || y < 0 || y >= grid_height) return TILE_WALL;
-	return tiles[(size_t)_tile_index(x, y)];
+	return grid.get_tile(x, y);
 }
 
 void GridManager::destroy_tile(int x, int y) {
-	if (is_tile_destructible(x, y)) {
-		set_tile(x, y, TILE_FLOOR);
+	if (grid.destroy_tile(x, y)) {
 		emit_signal("tile_destroyed", x, y);
 	}
 }
 
+int GridManager::get_blast_extent(int x, int y, int dx, int dy, int p_range) const {
+	return grid.blast_extent(x, y, dx, dy, p_range);
+}
+
 void GridManager::load_map_from_string(const String &p_map_data) {
-	PackedStringArray lines = p_map_data.split("\n", false);
-	int row = 0;
-	for (int i = 0; i < lines.size(); i++) {
-		String line = lines[i].strip_edges();
-		if (line.is_empty()) continue;
-		if (row >= grid_height) break;
-		for (int col = 0; col < line.length() && col < grid_width; col++) {
-			char32_t c = line[col];
-			if (c == '#') set_tile(col, row, TILE_WALL);
-			else if (c == 'x' || c == 'X') set_tile(col, row, TILE_DESTRUCTIBLE);
-			else set_tile(col, row, TILE_FLOOR);
-		}
-		row++;
+	// Narrow to ASCII in scratch memory instead of a heap CharString; non-ASCII becomes '?'
+	// (one byte per character keeps columns aligned).
+	int64_t length = p_map_data.length();
+	bomberman::FrameVector<char> ascii((size_t)length);
+	const char32_t *src = p_map_data.ptr();
+	for (int64_t i = 0; i < length; i++) {
+		ascii[(size_t)i] = src[i] < 128 ? (char)src[i] : '?';
 	}
+	grid.load_from_string(ascii.data(), ascii.size());
 }
 
 } // namespace godot
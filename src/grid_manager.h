@@ -1,33 +1,36 @@
 #ifndef BOMBERMAN_GRID_MANAGER_H
 #define BOMBERMAN_GRID_MANAGER_H
 
+#include "entity_registry.h"
+#include "grid_state.h"
+
 #include <godot_cpp/classes/node2d.hpp>
-#include <vector>
 
 namespace godot {
 
 /**
  * Manages grid-based map state and coordinate conversion.
  * Uses center-aligned cells: grid_to_world returns the center of each cell.
+ * Tile storage and blast rules live in bomberman::GridState (shared with the headless server).
  */
 class GridManager : public Node2D {
 	GDCLASS(GridManager, Node2D)
 
 public:
 	enum TileType {
-		TILE_FLOOR = 0,
-		TILE_WALL = 1,
-		TILE_DESTRUCTIBLE = 2,
+		TILE_FLOOR = bomberman::TILE_FLOOR,
+		TILE_WALL = bomberman::TILE_WALL,
+		TILE_DESTRUCTIBLE = bomberman::TILE_DESTRUCTIBLE,
 	};
 
 private:
-	int grid_width = 15;
-	int grid_height = 13;
 	int tile_size = 32;
 	Vector2 map_offset;
-	std::vector<int> tiles;
+	bomberman::GridState grid;
+	EntityHandle entity_handle = INVALID_ENTITY_HANDLE;
 
-	int _tile_index(int x, int y) const;
+	/** Creates the registry record; false (no-op) off the main thread. */
+	bool _register();
 
 protected:
 	static void _bind_methods();
@@ -36,6 +39,15 @@ public:
 	GridManager();
 	~GridManager();
 
+	void _enter_tree() override;
+
+	/** Registry handle; Player/Bomb reference this grid through it instead of a NodePath. 0 if asked off the main thread before registration. */
+	EntityHandle get_entity_handle() const;
+	/** Engine-independent tile state (C++ only). */
+	const bomberman::GridState &get_grid_state() const;
+	/** Replace size and every tile at once without emitting tile_destroyed (C++ only, used by MatchReplay). */
+	void assign_tiles(int p_width, int p_height, const uint8_t *p_tiles);
+
 	// Grid dimensions and conversion (center-aligned)
 	void set_grid_width(int p_width);
 	int get_grid_width() const;
@@ -54,10 +66,17 @@ public:
 	// Tile access
 	bool is_tile_walkable(int x, int y) const;
 	bool is_tile_destructible(int x, int y) const;
+	/** p_type must be a TileType value; anything else is rejected with an error. */
 	void set_tile(int x, int y, int p_type);
 	int get_tile(int x, int y) const;
 	void destroy_tile(int x, int y);
 
+	/**
+	 * Cells a blast from (x, y) reaches toward (dx, dy) for p_range, same rule as Bomb.
+	 * O(1) per call via GridState's reach tables; intended for AI danger queries.
+	 */
+	int get_blast_extent(int x, int y, int dx, int dy, int p_range) const;
+
 	/** Load map from string: . = floor, # = wall, x = destructible. Lines are rows. */
 	void load_map_from_string(const String &p_map_data);
 
@@ -0,0 +1,243 @@
+#ifndef BOMBERMAN_GRID_STATE_H
+#define BOMBERMAN_GRID_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bomberman {
+
+/** Tile values; kept in sync with GridManager::TileType. */
+enum TileType : uint8_t {
+	TILE_FLOOR = 0,
+	TILE_WALL = 1,
+	TILE_DESTRUCTIBLE = 2,
+};
+
+/** Ray directions for blast reach tables; (dx, dy) per entry of BLAST_DIR_DX/DY. */
+enum BlastDirection {
+	BLAST_EAST = 0,
+	BLAST_WEST = 1,
+	BLAST_SOUTH = 2,
+	BLAST_NORTH = 3,
+	BLAST_DIRECTION_COUNT = 4,
+};
+
+static constexpr int BLAST_DIR_DX[BLAST_DIRECTION_COUNT] = { 1, -1, 0, 0 };
+static constexpr int BLAST_DIR_DY[BLAST_DIRECTION_COUNT] = { 0, 0, 1, -1 };
+
+/**
+ * Engine-independent tile grid and blast rules, shared by GridManager and the headless server.
+ * Out-of-bounds cells read as TILE_WALL. Allocator is a template parameter so server rooms can
+ * keep their grids in a per-thread arena.
+ *
+ * Alongside the tiles it keeps, per cell and direction, the unbounded blast reach: how many
+ * cells a blast travels before a wall (exclusive) or destructible tile (inclusive). set_tile
+ * refreshes only the run of cells on the same row/column whose ray passes through the changed
+ * cell, so blast_extent is a single lookup.
+ */
+template <typename Allocator = std::allocator<uint8_t>>
+class BasicGridState {
+private:
+	struct CellReach {
+		uint16_t reach[BLAST_DIRECTION_COUNT];
+	};
+
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<CellReach> ReachAllocator;
+
+	static constexpr uint16_t MAX_REACH = 0xFFFF;
+
+	// How a tile affects a passing blast.
+	enum BlastClass {
+		BLAST_PASS,
+		BLAST_STOP_BEFORE, // wall / out of bounds
+		BLAST_STOP_AT, // destructible
+	};
+
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t, Allocator> tiles;
+	std::vector<CellReach, ReachAllocator> reach;
+
+	size_t _index(int x, int y) const { return (size_t)y * (size_t)width + (size_t)x; }
+
+	static BlastClass _blast_class(int p_tile) {
+		if (p_tile == TILE_WALL) return BLAST_STOP_BEFORE;
+		if (p_tile == TILE_DESTRUCTIBLE) return BLAST_STOP_AT;
+		return BLAST_PASS;
+	}
+
+	/** Reach of (x, y) in p_dir, from the neighbour's tile and the neighbour's own reach. */
+	uint16_t _reach_from_next(int x, int y, int p_dir) const {
+		int nx = x + BLAST_DIR_DX[p_dir];
+		int ny = y + BLAST_DIR_DY[p_dir];
+		if (!in_bounds(nx, ny)) return 0;
+		size_t next = _index(nx, ny);
+		switch (_blast_class(tiles[next])) {
+			case BLAST_STOP_BEFORE:
+				return 0;
+			case BLAST_STOP_AT:
+				return 1;
+			default:
+				return reach[next].reach[p_dir] < MAX_REACH ? (uint16_t)(reach[next].reach[p_dir] + 1) : MAX_REACH;
+		}
+	}
+
+	/** Refresh p_dir rays of the cells behind (x, y) that can see through to it. */
+	void _update_ray_line(int x, int y, int p_dir) {
+		int cx = x - BLAST_DIR_DX[p_dir];
+		int cy = y - BLAST_DIR_DY[p_dir];
+		while (in_bounds(cx, cy)) {
+			reach[_index(cx, cy)].reach[p_dir] = _reach_from_next(cx, cy, p_dir);
+			// Cells further back only depend on this one if blasts pass through it.
+			if (_blast_class(tiles[_index(cx, cy)]) != BLAST_PASS) break;
+			cx -= BLAST_DIR_DX[p_dir];
+			cy -= BLAST_DIR_DY[p_dir];
+		}
+	}
+
+	void _rebuild_reach() {
+		reach.resize(tiles.size());
+		for (int y = 0; y < height; y++) {
+			for (int x = width - 1; x >= 0; x--) reach[_index(x, y)].reach[BLAST_EAST] = _reach_from_next(x, y, BLAST_EAST);
+			for (int x = 0; x < width; x++) reach[_index(x, y)].reach[BLAST_WEST] = _reach_from_next(x, y, BLAST_WEST);
+		}
+		for (int x = 0; x < width; x++) {
+			for (int y = height - 1; y >= 0; y--) reach[_index(x, y)].reach[BLAST_SOUTH] = _reach_from_next(x, y, BLAST_SOUTH);
+			for (int y = 0; y < height; y++) reach[_index(x, y)].reach[BLAST_NORTH] = _reach_from_next(x, y, BLAST_NORTH);
+		}
+	}
+
+	/** Reference cell-by-cell walk; used for origins/directions the tables do not cover. */
+	int _walk_blast_extent(int x, int y, int dx, int dy, int p_range) const {
+		int extent = 0;
+		for (int d = 1; d <= p_range; d++) {
+			int tile = get_tile(x + dx * d, y + dy * d);
+			if (tile == TILE_WALL) break;
+			extent = d;
+			if (tile == TILE_DESTRUCTIBLE) break;
+		}
+		return extent;
+	}
+
+public:
+	explicit BasicGridState(int p_width = 15, int p_height = 13, const Allocator &p_alloc = Allocator()) :
+			tiles(p_alloc),
+			reach(ReachAllocator(p_alloc)) {
+		resize(p_width, p_height);
+	}
+
+	/** Non-positive sizes are ignored. Existing tiles keep their flat index (same as GridManager). */
+	void resize(int p_width, int p_height) {
+		if (p_width <= 0 || p_height <= 0) return;
+		width = p_width;
+		height = p_height;
+		tiles.resize((size_t)width * (size_t)height, TILE_FLOOR);
+		_rebuild_reach();
+	}
+
+	int get_width() const { return width; }
+	int get_height() const { return height; }
+
+	bool in_bounds(int x, int y) const {
+		return x >= 0 && x < width && y >= 0 && y < height;
+	}
+
+	int get_tile(int x, int y) const {
+		if (!in_bounds(x, y)) return TILE_WALL;
+		return tiles[_index(x, y)];
+	}
+
+	void set_tile(int x, int y, int p_type) {
+		if (!in_bounds(x, y)) return;
+		uint8_t &tile = tiles[_index(x, y)];
+		uint8_t old = tile;
+		tile = (uint8_t)p_type;
+		if (_blast_class(old) == _blast_class(tile)) return;
+		for (int dir = 0; dir < BLAST_DIRECTION_COUNT; dir++) {
+			_update_ray_line(x, y, dir);
+		}
+	}
+
+	bool is_walkable(int x, int y) const { return get_tile(x, y) == TILE_FLOOR; }
+	bool is_destructible(int x, int y) const { return get_tile(x, y) == TILE_DESTRUCTIBLE; }
+
+	/** Row-major tiles, width * height bytes. */
+	const uint8_t *get_tile_data() const { return tiles.data(); }
+
+	/** Replaces the whole grid (e.g. from a replay keyframe); one reach-table rebuild. */
+	void assign(int p_width, int p_height, const uint8_t *p_tiles) {
+		if (p_width <= 0 || p_height <= 0) return;
+		width = p_width;
+		height = p_height;
+		tiles.assign(p_tiles, p_tiles + (size_t)width * (size_t)height);
+		_rebuild_reach();
+	}
+
+	/** Turns a destructible tile into floor; returns true if something was destroyed. */
+	bool destroy_tile(int x, int y) {
+		if (!is_destructible(x, y)) return false;
+		set_tile(x, y, TILE_FLOOR);
+		return true;
+	}
+
+	/** Unbounded blast reach from in-bounds cell (x, y) in p_dir. */
+	int get_blast_reach(int x, int y, BlastDirection p_dir) const {
+		return reach[_index(x, y)].reach[p_dir];
+	}
+
+	/**
+	 * Number of cells a blast from (x, y) reaches in direction (dx, dy), up to p_range.
+	 * Stops before a wall; includes the first destructible tile, then stops.
+	 * O(1) for in-bounds origins and unit axis directions.
+	 */
+	int blast_extent(int x, int y, int dx, int dy, int p_range) const {
+		if (p_range <= 0) return 0;
+		int dir;
+		if (dx == 1 && dy == 0) dir = BLAST_EAST;
+		else if (dx == -1 && dy == 0) dir = BLAST_WEST;
+		else if (dx == 0 && dy == 1) dir = BLAST_SOUTH;
+		else if (dx == 0 && dy == -1) dir = BLAST_NORTH;
+		else return _walk_blast_extent(x, y, dx, dy, p_range);
+		if (!in_bounds(x, y)) return _walk_blast_extent(x, y, dx, dy, p_range);
+		int r = reach[_index(x, y)].reach[dir];
+		return r < p_range ? r : p_range;
+	}
+
+	/**
+	 * Load map text: . = floor, # = wall, x = destructible. One row per line;
+	 * lines are trimmed and blank lines skipped. Map characters are ASCII.
+	 */
+	void load_from_string(const char *p_data, size_t p_length) {
+		int row = 0;
+		size_t pos = 0;
+		while (pos < p_length && row < height) {
+			size_t end = pos;
+			while (end < p_length && p_data[end] != '\n') end++;
+			size_t begin = pos;
+			size_t stop = end;
+			while (begin < stop && (unsigned char)p_data[begin] <= ' ') begin++;
+			while (stop > begin && (unsigned char)p_data[stop - 1] <= ' ') stop--;
+			if (stop > begin) {
+				for (int col = 0; col < (int)(stop - begin) && col < width; col++) {
+					char c = p_data[begin + col];
+					uint8_t &tile = tiles[_index(col, row)];
+					if (c == '#') tile = TILE_WALL;
+					else if (c == 'x' || c == 'X') tile = TILE_DESTRUCTIBLE;
+					else tile = TILE_FLOOR;
+				}
+				row++;
+			}
+			pos = end + 1;
+		}
+		// Whole-map change: one O(w*h) rebuild instead of per-tile ray updates.
+		_rebuild_reach();
+	}
+};
+
+typedef BasicGridState<> GridState;
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_GRID_STATE_H
@@ -0,0 +1,133 @@
+#include "match_recorder.h"
+#include "grid_manager.h"
+#include <godot_cpp/core/class_db.hpp>
+
+#include <cstring>
+
+namespace godot {
+
+void MatchRecorder::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("start", "path"), &MatchRecorder::start);
+	ClassDB::bind_method(D_METHOD("stop"), &MatchRecorder::stop);
+	ClassDB::bind_method(D_METHOD("is_recording"), &MatchRecorder::is_recording);
+	ClassDB::bind_method(D_METHOD("record_tick"), &MatchRecorder::record_tick);
+	ClassDB::bind_method(D_METHOD("set_grid_manager_handle", "handle"), &MatchRecorder::set_grid_manager_handle);
+	ClassDB::bind_method(D_METHOD("get_grid_manager_handle"), &MatchRecorder::get_grid_manager_handle);
+	ClassDB::bind_method(D_METHOD("set_keyframe_interval", "interval"), &MatchRecorder::set_keyframe_interval);
+	ClassDB::bind_method(D_METHOD("get_keyframe_interval"), &MatchRecorder::get_keyframe_interval);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_manager_handle", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_grid_manager_handle", "get_grid_manager_handle");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "keyframe_interval"), "set_keyframe_interval", "get_keyframe_interval");
+}
+
+MatchRecorder::MatchRecorder() {}
+
+MatchRecorder::~MatchRecorder() {
+	stop();
+}
+
+void MatchRecorder::_physics_process(double delta) {
+	if (is_recording()) {
+		record_tick();
+	}
+}
+
+Error MatchRecorder::start(const String &p_path) {
+	stop();
+	file = FileAccess::open(p_path, FileAccess::WRITE);
+	if (file.is_null()) {
+		return FileAccess::get_open_error();
+	}
+	encoder = bomberman::StateDeltaEncoder((uint32_t)keyframe_interval);
+	tick = 0;
+	bytes.clear();
+	bomberman::StateDeltaEncoder::write_header(bytes, (uint32_t)keyframe_interval);
+	_write_bytes();
+	return OK;
+}
+
+void MatchRecorder::stop() {
+	if (file.is_valid()) {
+		file->close();
+		file.unref();
+	}
+}
+
+bool MatchRecorder::is_recording() const {
+	return file.is_valid();
+}
+
+void MatchRecorder::_capture_snapshot() {
+	EntityRegistry *registry = EntityRegistry::get_singleton();
+	snapshot.tick = tick;
+	snapshot.clear_entities();
+
+	GridManager *grid_manager = registry->get_grid_manager(grid_manager_handle);
+	if (grid_manager) {
+		const bomberman::GridState &grid = grid_manager->get_grid_state();
+		snapshot.width = grid.get_width();
+		snapshot.height = grid.get_height();
+		const uint8_t *data = grid.get_tile_data();
+		snapshot.tiles.assign(data, data + (size_t)grid.get_width() * (size_t)grid.get_height());
+	}
+
+	// Entity ids are registry handles: stable for an entity's lifetime, never reused.
+	for (size_t i = 0; i < registry->players.size(); i++) {
+		const PlayerState &p = registry->players.at(i);
+		if (p.grid_manager != grid_manager_handle) continue;
+		bomberman::StreamPlayer e;
+		e.id = registry->players.handle_at(i);
+		e.x = p.grid_x;
+		e.y = p.grid_y;
+		e.alive = p.is_alive;
+		snapshot.players.push_back(e);
+	}
+	for (size_t i = 0; i < registry->bombs.size(); i++) {
+		const BombState &b = registry->bombs.at(i);
+		// An exploded bomb counts as detonated even while its node waits for queue_free.
+		if (b.grid_manager != grid_manager_handle || b.has_exploded) continue;
+		bomberman::StreamBomb e;
+		e.id = registry->bombs.handle_at(i);
+		e.x = b.grid_x;
+		e.y = b.grid_y;
+		e.flame_range = b.flame_range;
+		snapshot.bombs.push_back(e);
+	}
+	// Power-ups are not tied to a grid; a scene hosts a single match.
+	for (size_t i = 0; i < registry->power_ups.size(); i++) {
+		const PowerUpState &u = registry->power_ups.at(i);
+		bomberman::StreamPowerUp e;
+		e.id = registry->power_ups.handle_at(i);
+		e.x = u.grid_x;
+		e.y = u.grid_y;
+		e.type = u.type;
+		snapshot.power_ups.push_back(e);
+	}
+}
+
+void MatchRecorder::_write_bytes() {
+	if (bytes.empty()) return;
+	// Reused buffer: same size as last tick means no reallocation.
+	write_buffer.resize((int64_t)bytes.size());
+	std::memcpy(write_buffer.ptrw(), bytes.data(), bytes.size());
+	file->store_buffer(write_buffer);
+	file->flush();
+	bytes.clear();
+}
+
+void MatchRecorder::record_tick() {
+	if (!is_recording()) return;
+	_capture_snapshot();
+	ERR_FAIL_COND_MSG((uint64_t)snapshot.width * (uint64_t)snapshot.height > bomberman::STATE_STREAM_MAX_TILES,
+			"Grid is too large to record as a state stream.");
+	encoder.encode(snapshot, bytes);
+	_write_bytes();
+	tick++;
+}
+
+void MatchRecorder::set_grid_manager_handle(EntityHandle p_handle) { grid_manager_handle = p_handle; }
+EntityHandle MatchRecorder::get_grid_manager_handle() const { return grid_manager_handle; }
+void MatchRecorder::set_keyframe_interval(int p_interval) { keyframe_interval = p_interval > 0 ? p_interval : 1; }
+int MatchRecorder::get_keyframe_interval() const { return keyframe_interval; }
+
+} // namespace godot
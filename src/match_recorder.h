@@ -0,0 +1,59 @@
+#ifndef BOMBERMAN_MATCH_RECORDER_H
+#define BOMBERMAN_MATCH_RECORDER_H
+
+#include "entity_registry.h"
+#include "state_stream.h"
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <vector>
+
+namespace godot {
+
+/**
+ * Writes a state-delta stream (see state_stream.h) of one GridManager's match every physics
+ * tick: changed tiles, player positions/alive flags, bomb and power-up spawns/removals.
+ * Each record is flushed as it is written so spectators can tail the file live.
+ */
+class MatchRecorder : public Node {
+	GDCLASS(MatchRecorder, Node)
+
+private:
+	EntityHandle grid_manager_handle = INVALID_ENTITY_HANDLE;
+	int keyframe_interval = 300;
+	Ref<FileAccess> file;
+	bomberman::StateDeltaEncoder encoder;
+	bomberman::MatchSnapshot snapshot;
+	std::vector<uint8_t> bytes;
+	PackedByteArray write_buffer;
+	uint64_t tick = 0;
+
+	void _capture_snapshot();
+	void _write_bytes();
+
+protected:
+	static void _bind_methods();
+
+public:
+	MatchRecorder();
+	~MatchRecorder();
+
+	void _physics_process(double delta) override;
+
+	/** Opens p_path for writing and writes the stream header. Recording runs until stop(). */
+	Error start(const String &p_path);
+	void stop();
+	bool is_recording() const;
+	/** Captures and writes one tick now; called automatically every physics tick while recording. */
+	void record_tick();
+
+	void set_grid_manager_handle(EntityHandle p_handle);
+	EntityHandle get_grid_manager_handle() const;
+	void set_keyframe_interval(int p_interval);
+	int get_keyframe_interval() const;
+};
+
+} // namespace godot
+
+#endif // BOMBERMAN_MATCH_RECORDER_H
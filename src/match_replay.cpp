@@ -0,0 +1,132 @@
+#include "match_replay.h"
+#include "grid_manager.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <cstring>
+
+namespace godot {
+
+size_t FileAccessByteSource::read(uint8_t *r_dst, size_t p_size) {
+	if (file.is_null() || p_size == 0) return 0;
+	PackedByteArray data = file->get_buffer((int64_t)p_size);
+	size_t count = (size_t)data.size();
+	if (count > 0) {
+		std::memcpy(r_dst, data.ptr(), count);
+	}
+	return count;
+}
+
+bool FileAccessByteSource::seek(uint64_t p_position) {
+	if (file.is_null()) return false;
+	file->seek(p_position);
+	return true;
+}
+
+uint64_t FileAccessByteSource::position() const {
+	return file.is_valid() ? file->get_position() : 0;
+}
+
+void MatchReplay::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open", "path"), &MatchReplay::open);
+	ClassDB::bind_method(D_METHOD("advance"), &MatchReplay::advance);
+	ClassDB::bind_method(D_METHOD("seek_keyframe", "index"), &MatchReplay::seek_keyframe);
+	ClassDB::bind_method(D_METHOD("has_state"), &MatchReplay::has_state);
+	ClassDB::bind_method(D_METHOD("get_tick"), &MatchReplay::get_tick);
+	ClassDB::bind_method(D_METHOD("get_keyframe_interval"), &MatchReplay::get_keyframe_interval);
+	ClassDB::bind_method(D_METHOD("apply_to_grid_manager", "grid_manager"), &MatchReplay::apply_to_grid_manager);
+	ClassDB::bind_method(D_METHOD("get_players"), &MatchReplay::get_players);
+	ClassDB::bind_method(D_METHOD("get_bombs"), &MatchReplay::get_bombs);
+	ClassDB::bind_method(D_METHOD("get_power_ups"), &MatchReplay::get_power_ups);
+
+	ClassDB::bind_integer_constant(get_class_static(), "StreamResult", "RESULT_OK", RESULT_OK);
+	ClassDB::bind_integer_constant(get_class_static(), "StreamResult", "RESULT_END", RESULT_END);
+	ClassDB::bind_integer_constant(get_class_static(), "StreamResult", "RESULT_INCOMPLETE", RESULT_INCOMPLETE);
+	ClassDB::bind_integer_constant(get_class_static(), "StreamResult", "RESULT_CORRUPT", RESULT_CORRUPT);
+}
+
+MatchReplay::MatchReplay() :
+		decoder(&source) {}
+
+Error MatchReplay::open(const String &p_path) {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+	if (file.is_null()) {
+		return FileAccess::get_open_error();
+	}
+	source.set_file(file);
+	decoder = bomberman::StateDeltaDecoder(&source);
+	// A header not yet flushed by a live recorder is read again by the first advance().
+	if (decoder.read_header() == bomberman::StateDeltaDecoder::RESULT_CORRUPT) {
+		return ERR_FILE_CORRUPT;
+	}
+	return OK;
+}
+
+int MatchReplay::advance() {
+	return decoder.next();
+}
+
+int MatchReplay::seek_keyframe(int p_index) {
+	ERR_FAIL_COND_V(p_index < 0, RESULT_CORRUPT);
+	return decoder.seek_keyframe((uint32_t)p_index);
+}
+
+bool MatchReplay::has_state() const {
+	return decoder.has_state();
+}
+
+int64_t MatchReplay::get_tick() const {
+	return (int64_t)decoder.get_state().tick;
+}
+
+int MatchReplay::get_keyframe_interval() const {
+	return (int)decoder.get_keyframe_interval();
+}
+
+void MatchReplay::apply_to_grid_manager(GridManager *p_grid_manager) const {
+	ERR_FAIL_NULL(p_grid_manager);
+	ERR_FAIL_COND(!decoder.has_state());
+	const bomberman::MatchSnapshot &state = decoder.get_state();
+	p_grid_manager->assign_tiles(state.width, state.height, state.tiles.data());
+}
+
+Array MatchReplay::get_players() const {
+	Array result;
+	for (const bomberman::StreamPlayer &p : decoder.get_state().players) {
+		Dictionary d;
+		d["id"] = p.id;
+		d["x"] = p.x;
+		d["y"] = p.y;
+		d["alive"] = p.alive;
+		result.append(d);
+	}
+	return result;
+}
+
+Array MatchReplay::get_bombs() const {
+	Array result;
+	for (const bomberman::StreamBomb &b : decoder.get_state().bombs) {
+		Dictionary d;
+		d["id"] = b.id;
+		d["x"] = b.x;
+		d["y"] = b.y;
+		d["flame_range"] = b.flame_range;
+		result.append(d);
+	}
+	return result;
+}
+
+Array MatchReplay::get_power_ups() const {
+	Array result;
+	for (const bomberman::StreamPowerUp &u : decoder.get_state().power_ups) {
+		Dictionary d;
+		d["id"] = u.id;
+		d["x"] = u.x;
+		d["y"] = u.y;
+		d["type"] = u.type;
+		result.append(d);
+	}
+	return result;
+}
+
+} // namespace godot
@@ -0,0 +1,73 @@
+#ifndef BOMBERMAN_MATCH_REPLAY_H
+#define BOMBERMAN_MATCH_REPLAY_H
+
+#include "state_stream.h"
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+namespace godot {
+
+class GridManager;
+
+/** ByteSource over an engine FileAccess, so replays can read user:// and res:// paths. */
+class FileAccessByteSource : public bomberman::ByteSource {
+private:
+	Ref<FileAccess> file;
+
+public:
+	void set_file(const Ref<FileAccess> &p_file) { file = p_file; }
+	size_t read(uint8_t *r_dst, size_t p_size) override;
+	bool seek(uint64_t p_position) override;
+	uint64_t position() const override;
+};
+
+/**
+ * Reads a stream written by MatchRecorder, one tick per advance(). Memory stays constant
+ * however long the match was. Works on files still being recorded: RESULT_INCOMPLETE and
+ * RESULT_END mean "try again later", not failure.
+ */
+class MatchReplay : public RefCounted {
+	GDCLASS(MatchReplay, RefCounted)
+
+public:
+	enum StreamResult {
+		RESULT_OK = bomberman::StateDeltaDecoder::RESULT_OK,
+		RESULT_END = bomberman::StateDeltaDecoder::RESULT_END,
+		RESULT_INCOMPLETE = bomberman::StateDeltaDecoder::RESULT_INCOMPLETE,
+		RESULT_CORRUPT = bomberman::StateDeltaDecoder::RESULT_CORRUPT,
+	};
+
+private:
+	FileAccessByteSource source;
+	bomberman::StateDeltaDecoder decoder;
+
+protected:
+	static void _bind_methods();
+
+public:
+	MatchReplay();
+
+	Error open(const String &p_path);
+	/** Applies the next record. Returns a StreamResult. */
+	int advance();
+	/** Jumps to the p_index-th keyframe (0-based). Returns a StreamResult. */
+	int seek_keyframe(int p_index);
+
+	bool has_state() const;
+	int64_t get_tick() const;
+	int get_keyframe_interval() const;
+
+	/** Writes the decoded tiles into p_grid_manager without emitting tile_destroyed; refresh the TileMap afterwards. */
+	void apply_to_grid_manager(GridManager *p_grid_manager) const;
+	/** Arrays of Dictionaries: {id, x, y, alive} / {id, x, y, flame_range} / {id, x, y, type}. */
+	Array get_players() const;
+	Array get_bombs() const;
+	Array get_power_ups() const;
+};
+
+} // namespace godot
+
+#endif // BOMBERMAN_MATCH_REPLAY_H
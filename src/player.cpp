@@ -1,5 +1,6 @@
 #include "player.h"
 #include "grid_manager.h"
+#include "game_rules.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/classes/engine.hpp>
 
@@ -16,6 +17,7 @@ void Player::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("can_place_bomb"), &Player::can_place_bomb);
 	ClassDB::bind_method(D_METHOD("place_bomb"), &Player::place_bomb);
 	ClassDB::bind_method(D_METHOD("on_bomb_exploded"), &Player::on_bomb_exploded);
+	ClassDB::bind_method(D_METHOD("collect_power_up"), &Player::collect_power_up);
 	ClassDB::bind_method(D_METHOD("die"), &Player::die);
 	ClassDB::bind_method(D_METHOD("take_damage"), &Player::take_damage);
 	ClassDB::bind_method(D_METHOD("set_move_speed", "speed"), &Player::set_move_speed);
@@ -27,6 +29,9 @@ void Player::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_flame_range"), &Player::get_flame_range);
 	ClassDB::bind_method(D_METHOD("set_grid_manager_path", "path"), &Player::set_grid_manager_path);
 	ClassDB::bind_method(D_METHOD("get_grid_manager_path"), &Player::get_grid_manager_path);
+	ClassDB::bind_method(D_METHOD("set_grid_manager_handle", "handle"), &Player::set_grid_manager_handle);
+	ClassDB::bind_method(D_METHOD("get_grid_manager_handle"), &Player::get_grid_manager_handle);
+	ClassDB::bind_method(D_METHOD("get_entity_handle"), &Player::get_entity_handle);
 	ClassDB::bind_method(D_METHOD("set_is_alive", "alive"), &Player::set_is_alive);
 	ClassDB::bind_method(D_METHOD("get_is_alive"), &Player::get_is_alive);
 
@@ -36,19 +41,57 @@ void Player::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "bomb_capacity"), "set_bomb_capacity", "get_bomb_capacity");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "flame_range"), "set_flame_range", "get_flame_range");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "grid_manager_path"), "set_grid_manager_path", "get_grid_manager_path");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "grid_manager_handle", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_grid_manager_handle", "get_grid_manager_handle");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "is_alive"), "set_is_alive", "get_is_alive");
 
 	ADD_SIGNAL(MethodInfo("grid_position_changed", PropertyInfo(Variant::VECTOR2I, "grid_pos")));
 	ADD_SIGNAL(MethodInfo("died"));
 }
 
-Player::Player() {}
+Player::Player() {
+	// The registry record is created on the main thread on first use (see _register).
+}
+
+Player::~Player() {
+	EntityRegistry::release(entity_handle);
+}
+
+bool Player::_register() {
+	if (entity_handle != INVALID_ENTITY_HANDLE) return true;
+	if (!EntityRegistry::is_main_thread()) return false;
+	PlayerState state = unregistered_state;
+	state.node = this;
+	entity_handle = EntityRegistry::get_singleton()->players.create(state);
+	return true;
+}
+
+PlayerState &Player::_state() {
+	// Until registered (built off the main thread, not used there yet) state lives in the node.
+	if (!_register()) return unregistered_state;
+	PlayerState *state = EntityRegistry::get_singleton()->players.get(entity_handle);
+	CRASH_COND_MSG(!state, "Player has no registry record (stale entity handle).");
+	return *state;
+}
+
+const PlayerState &Player::_state() const {
+	return const_cast<Player *>(this)->_state();
+}
 
-Player::~Player() {}
+void Player::_enter_tree() {
+	_register();
+}
+
+GridManager *Player::_grid_manager() const {
+	return EntityRegistry::get_singleton()->get_grid_manager(_state().grid_manager);
+}
 
 void Player::_ready() {
-	if (!grid_manager_path.is_empty()) {
-		grid_manager = get_node<GridManager>(grid_manager_path);
+	// One-time path resolution for scene wiring; everything after this goes through the handle.
+	if (!grid_manager_path.is_empty() && _state().grid_manager == INVALID_ENTITY_HANDLE) {
+		GridManager *gm = get_node<GridManager>(grid_manager_path);
+		if (gm) {
+			_state().grid_manager = gm->get_entity_handle();
+		}
 	}
 	_update_world_position();
 }
@@ -58,77 +101,90 @@ void Player::_physics_process(double delta) {
 	// Optional: could add automatic interpolation here later
 }
 
+EntityHandle Player::get_entity_handle() const {
+	const_cast<Player *>(this)->_register();
+	return entity_handle;
+}
+
 void Player::_update_world_position() {
+	GridManager *grid_manager = _grid_manager();
 	if (grid_manager) {
-		Vector2 world = grid_manager->grid_to_world(grid_x, grid_y);
+		const PlayerState &state = _state();
+		Vector2 world = grid_manager->grid_to_world(state.grid_x, state.grid_y);
 		set_position(world);
 	}
 }
 
-void Player::set_grid_x(int x) { grid_x = x; }
-int Player::get_grid_x() const { return grid_x; }
-void Player::set_grid_y(int y) { grid_y = y; }
-int Player::get_grid_y() const { return grid_y; }
+void Player::set_grid_x(int x) { _state().grid_x = x; }
+int Player::get_grid_x() const { return _state().grid_x; }
+void Player::set_grid_y(int y) { _state().grid_y = y; }
+int Player::get_grid_y() const { return _state().grid_y; }
 
 void Player::set_grid_position(int x, int y) {
-	grid_x = x;
-	grid_y = y;
+	PlayerState &state = _state();
+	state.grid_x = x;
+	state.grid_y = y;
 	_update_world_position();
-	emit_signal("grid_position_changed", Vector2i(grid_x, grid_y));
+	emit_signal("grid_position_changed", Vector2i(x, y));
 }
 
 bool Player::move_direction(int dx, int dy) {
-	if (!grid_manager || !is_alive) return false;
-	int nx = grid_x + dx;
-	int ny = grid_y + dy;
-	if (!can_move_to(nx, ny)) return false;
-	grid_x = nx;
-	grid_y = ny;
+	GridManager *grid_manager = _grid_manager();
+	if (!grid_manager) return false;
+	PlayerState &state = _state();
+	if (!bomberman::try_move(state, grid_manager->get_grid_state(), dx, dy)) return false;
 	_update_world_position();
-	emit_signal("grid_position_changed", Vector2i(grid_x, grid_y));
+	emit_signal("grid_position_changed", Vector2i(state.grid_x, state.grid_y));
 	return true;
 }
 
 bool Player::can_move_to(int x, int y) const {
+	GridManager *grid_manager = _grid_manager();
 	if (!grid_manager) return false;
 	return grid_manager->is_tile_walkable(x, y);
 }
 
 bool Player::can_place_bomb() const {
-	return is_alive && active_bombs < bomb_capacity;
+	return bomberman::can_place_bomb(_state());
 }
 
 void Player::place_bomb() {
-	if (!can_place_bomb()) return;
-	active_bombs++;
+	bomberman::place_bomb(_state());
 }
 
 void Player::on_bomb_exploded() {
-	if (active_bombs > 0) active_bombs--;
+	bomberman::release_bomb(_state());
+}
+
+void Player::collect_power_up() {
+	bomberman::apply_power_up(_state());
 }
 
 void Player::die() {
-	if (!is_alive) return;
-	is_alive = false;
+	PlayerState &state = _state();
+	if (!state.is_alive) return;
+	state.is_alive = false;
 	emit_signal("died");
 }
 
 bool Player::take_damage() {
-	if (!is_alive) return false;
+	if (!_state().is_alive) return false;
 	die();
 	return true;
 }
 
-void Player::set_move_speed(double p_speed) { move_speed = p_speed; }
-double Player::get_move_speed() const { return move_speed; }
-void Player::set_bomb_capacity(int p_cap) { bomb_capacity = p_cap; }
-int Player::get_bomb_capacity() const { return bomb_capacity; }
-int Player::get_active_bombs() const { return active_bombs; }
-void Player::set_flame_range(int p_range) { flame_range = p_range; }
-int Player::get_flame_range() const { return flame_range; }
+void Player::set_move_speed(double p_speed) { _state().move_speed = p_speed; }
+double Player::get_move_speed() const { return _state().move_speed; }
+void Player::set_bomb_capacity(int p_cap) { _state().bomb_capacity = p_cap; }
+int Player::get_bomb_capacity() const { return _state().bomb_capacity; }
+int Player::get_active_bombs() const { return _state().active_bombs; }
+void Player::set_flame_range(int p_range) { _state().flame_range = p_range; }
+int Player::get_flame_range() const { return _state().flame_range; }
 void Player::set_grid_manager_path(const NodePath &p_path) { grid_manager_path = p_path; }
 NodePath Player::get_grid_manager_path() const { return grid_manager_path; }
-void Player::set_is_alive(bool p_alive) { is_alive = p_alive; }
-bool Player::get_is_alive() const { return is_alive; }
+void Player::set_grid_manager_handle(EntityHandle p_handle) { _state().grid_manager = p_handle; }
+EntityHandle Player::get_grid_manager_handle() const { return _state().grid_manager; }
+void Player::set_is_alive(bool p_alive) { _state().is_alive = p_alive; }
+bool Player::get_is_alive() const { return _state().is_alive; }
 
 } // namespace godot
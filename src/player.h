@@ -1,6 +1,8 @@
 #ifndef BOMBERMAN_PLAYER_H
 #define BOMBERMAN_PLAYER_H
 
+#include "entity_registry.h"
+
 #include <godot_cpp/classes/character_body2d.hpp>
 #include <godot_cpp/variant/vector2.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
@@ -11,22 +13,22 @@ class GridManager;
 
 /**
  * Grid-aligned player. Movement snaps to cell center.
- * Requires a GridManager node (set grid_manager_path) to validate movement.
+ * Requires a GridManager (grid_manager_handle, or grid_manager_path resolved once in _ready)
+ * to validate movement. Gameplay state lives in EntityRegistry::players.
  */
 class Player : public CharacterBody2D {
 	GDCLASS(Player, CharacterBody2D)
 
 private:
-	int grid_x = 0;
-	int grid_y = 0;
-	double move_speed = 3.0;  // tiles per second
-	int bomb_capacity = 1;
-	int active_bombs = 0;
-	int flame_range = 1;
-	bool is_alive = true;
+	EntityHandle entity_handle = INVALID_ENTITY_HANDLE;
+	PlayerState unregistered_state;
 	NodePath grid_manager_path;
-	GridManager *grid_manager = nullptr;
 
+	PlayerState &_state();
+	const PlayerState &_state() const;
+	/** Creates the registry record from unregistered_state; false (no-op) off the main thread. */
+	bool _register();
+	GridManager *_grid_manager() const;
 	void _update_world_position();
 
 protected:
@@ -36,9 +38,12 @@ public:
 	Player();
 	~Player();
 
+	void _enter_tree() override;
 	void _ready() override;
 	void _physics_process(double delta) override;
 
+	EntityHandle get_entity_handle() const;
+
 	// Grid position (read/write for GDScript)
 	void set_grid_x(int x);
 	int get_grid_x() const;
@@ -54,6 +59,8 @@ public:
 	bool can_place_bomb() const;
 	void place_bomb();
 	void on_bomb_exploded();
+	// Flame range first, then bomb capacity, up to the caps in game_rules.h.
+	void collect_power_up();
 
 	// Phase 2: damage/death
 	void die();
@@ -69,6 +76,8 @@ public:
 	int get_flame_range() const;
 	void set_grid_manager_path(const NodePath &p_path);
 	NodePath get_grid_manager_path() const;
+	void set_grid_manager_handle(EntityHandle p_handle);
+	EntityHandle get_grid_manager_handle() const;
 	void set_is_alive(bool p_alive);
 	bool get_is_alive() const;
 
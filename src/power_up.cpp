@@ -6,6 +6,7 @@
 namespace godot {
 
 void PowerUp::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_entity_handle"), &PowerUp::get_entity_handle);
 	ClassDB::bind_method(D_METHOD("set_type", "type"), &PowerUp::set_type);
 	ClassDB::bind_method(D_METHOD("get_type"), &PowerUp::get_type);
 	ClassDB::bind_method(D_METHOD("set_grid_x", "x"), &PowerUp::set_grid_x);
@@ -28,9 +29,44 @@ void PowerUp::_bind_methods() {
 	ClassDB::bind_integer_constant(get_class_static(), "PowerUpType", "TYPE_REMOTE_DETONATOR", TYPE_REMOTE_DETONATOR);
 }
 
-PowerUp::PowerUp() {}
+PowerUp::PowerUp() {
+	unregistered_state.type = TYPE_FLAME_UP;
+	// The registry record is created on the main thread on first use (see _register).
+}
+
+PowerUp::~PowerUp() {
+	EntityRegistry::release(entity_handle);
+}
+
+bool PowerUp::_register() {
+	if (entity_handle != INVALID_ENTITY_HANDLE) return true;
+	if (!EntityRegistry::is_main_thread()) return false;
+	PowerUpState state = unregistered_state;
+	state.node = this;
+	entity_handle = EntityRegistry::get_singleton()->power_ups.create(state);
+	return true;
+}
+
+PowerUpState &PowerUp::_state() {
+	// Until registered (built off the main thread, not used there yet) state lives in the node.
+	if (!_register()) return unregistered_state;
+	PowerUpState *state = EntityRegistry::get_singleton()->power_ups.get(entity_handle);
+	CRASH_COND_MSG(!state, "PowerUp has no registry record (stale entity handle).");
+	return *state;
+}
+
+const PowerUpState &PowerUp::_state() const {
+	return const_cast<PowerUp *>(this)->_state();
+}
 
-PowerUp::~PowerUp() {}
+void PowerUp::_enter_tree() {
+	_register();
+}
+
+EntityHandle PowerUp::get_entity_handle() const {
+	const_cast<PowerUp *>(this)->_register();
+	return entity_handle;
+}
 
 void PowerUp::_ready() {
 	connect("body_entered", Callable(this, "_on_body_entered"));
@@ -47,12 +83,12 @@ void PowerUp::_on_body_entered(const Variant &body_v) {
 	}
 }
 
-void PowerUp::set_type(int p_type) { type = p_type; }
-int PowerUp::get_type() const { return type; }
-void PowerUp::set_grid_x(int x) { grid_x = x; }
-int PowerUp::get_grid_x() const { return grid_x; }
-void PowerUp::set_grid_y(int y) { grid_y = y; }
-int PowerUp::get_grid_y() const { return grid_y; }
-void PowerUp::set_grid_position(int x, int y) { grid_x = x; grid_y = y; }
+void PowerUp::set_type(int p_type) { _state().type = p_type; }
+int PowerUp::get_type() const { return _state().type; }
+void PowerUp::set_grid_x(int x) { _state().grid_x = x; }
+int PowerUp::get_grid_x() const { return _state().grid_x; }
+void PowerUp::set_grid_y(int y) { _state().grid_y = y; }
+int PowerUp::get_grid_y() const { return _state().grid_y; }
+void PowerUp::set_grid_position(int x, int y) { _state().grid_x = x; _state().grid_y = y; }
 
 } // namespace godot
@@ -1,6 +1,8 @@
 #ifndef BOMBERMAN_POWER_UP_H
 #define BOMBERMAN_POWER_UP_H
 
+#include "entity_registry.h"
+
 #include <godot_cpp/classes/area2d.hpp>
 #include <godot_cpp/variant/variant.hpp>
 
@@ -25,9 +27,13 @@ public:
 	};
 
 private:
-	int type = TYPE_FLAME_UP;
-	int grid_x = 0;
-	int grid_y = 0;
+	EntityHandle entity_handle = INVALID_ENTITY_HANDLE;
+	PowerUpState unregistered_state;
+
+	PowerUpState &_state();
+	const PowerUpState &_state() const;
+	/** Creates the registry record from unregistered_state; false (no-op) off the main thread. */
+	bool _register();
 
 	void _on_body_entered(const Variant &body_v);
 
@@ -38,8 +44,11 @@ public:
 	PowerUp();
 	~PowerUp();
 
+	void _enter_tree() override;
 	void _ready() override;
 
+	EntityHandle get_entity_handle() const;
+
 	void set_type(int p_type);
 	int get_type() const;
 	void set_grid_x(int x);
@@ -4,13 +4,29 @@
 #include "player.h"
 #include "bomb.h"
 #include "power_up.h"
+#include "match_recorder.h"
+#include "match_replay.h"
+#include "frame_arena.h"
+#include "frame_arena_clock.h"
 
 #include <gdextension_interface.h>
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/core/defs.hpp>
+#include <godot_cpp/core/error_macros.hpp>
 #include <godot_cpp/godot.hpp>
 
 using namespace godot;
 
+static void _report_frame_arena_error(const char *p_message) {
+	ERR_PRINT(p_message);
+}
+
+static uint64_t _engine_frame_counter() {
+	// Changes on every idle frame and every physics step.
+	Engine *engine = Engine::get_singleton();
+	return engine->get_process_frames() + engine->get_physics_frames();
+}
+
 void initialize_bomberman_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
@@ -20,12 +36,22 @@ void initialize_bomberman_module(ModuleInitializationLevel p_level) {
 	ClassDB::register_class<Player>();
 	ClassDB::register_class<Bomb>();
 	ClassDB::register_class<PowerUp>();
+	ClassDB::register_class<MatchRecorder>();
+	ClassDB::register_class<MatchReplay>();
+	ClassDB::register_class<FrameArenaClock>();
+
+	bomberman::FrameArena::set_error_handler(_report_frame_arena_error);
+	// Module init runs on the main thread; this keeps its arena bounded even without FrameArenaClock.
+	bomberman::FrameArena::set_frame_counter(_engine_frame_counter);
 }
 
 void uninitialize_bomberman_module(ModuleInitializationLevel p_level) {
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+
+	bomberman::FrameArena::set_error_handler(nullptr);
+	bomberman::FrameArena::set_frame_counter(nullptr);
 }
 
 extern "C" {
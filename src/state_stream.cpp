@@ -0,0 +1,489 @@
+#include "state_stream.h"
+#include "grid_state.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bomberman {
+
+static const uint8_t STREAM_MAGIC[4] = { 'B', 'M', 'D', 'S' };
+// Upper bound on a single record; anything larger is treated as corruption rather than allocated.
+static const uint64_t MAX_RECORD_SIZE = 64u * 1024u * 1024u;
+
+// --- Varint coding -----------------------------------------------------------------------
+
+static void put_varint(std::vector<uint8_t> &r_out, uint64_t p_value) {
+	while (p_value >= 0x80) {
+		r_out.push_back((uint8_t)(p_value | 0x80));
+		p_value >>= 7;
+	}
+	r_out.push_back((uint8_t)p_value);
+}
+
+static void put_zigzag(std::vector<uint8_t> &r_out, int64_t p_value) {
+	put_varint(r_out, ((uint64_t)p_value << 1) ^ (uint64_t)(p_value >> 63));
+}
+
+/** Bounds-checked reader over one record; any overrun clears ok and yields zeros. */
+struct ByteReader {
+	const uint8_t *ptr;
+	const uint8_t *end;
+	bool ok = true;
+
+	ByteReader(const uint8_t *p_data, size_t p_size) :
+			ptr(p_data), end(p_data + p_size) {}
+
+	uint8_t byte() {
+		if (ptr >= end) {
+			ok = false;
+			return 0;
+		}
+		return *ptr++;
+	}
+
+	uint64_t varint() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			uint8_t b = byte();
+			if (!ok) return 0;
+			value |= (uint64_t)(b & 0x7F) << shift;
+			if (!(b & 0x80)) return value;
+		}
+		ok = false;
+		return 0;
+	}
+
+	int64_t zigzag() {
+		uint64_t v = varint();
+		return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+	}
+};
+
+// --- Per-entity field coding -------------------------------------------------------------
+// Coordinates are zigzag deltas against the previous value of the same entity (0 if new).
+
+static void write_fields(std::vector<uint8_t> &r_out, const StreamPlayer *p_prev, const StreamPlayer &p_cur) {
+	put_zigzag(r_out, (int64_t)p_cur.x - (p_prev ? p_prev->x : 0));
+	put_zigzag(r_out, (int64_t)p_cur.y - (p_prev ? p_prev->y : 0));
+	r_out.push_back(p_cur.alive ? 1 : 0);
+}
+
+static void read_fields(ByteReader &r_reader, StreamPlayer &r_entity) {
+	r_entity.x += (int32_t)r_reader.zigzag();
+	r_entity.y += (int32_t)r_reader.zigzag();
+	r_entity.alive = r_reader.byte() != 0;
+}
+
+static bool same_fields(const StreamPlayer &a, const StreamPlayer &b) {
+	return a.x == b.x && a.y == b.y && a.alive == b.alive;
+}
+
+static void write_fields(std::vector<uint8_t> &r_out, const StreamBomb *p_prev, const StreamBomb &p_cur) {
+	put_zigzag(r_out, (int64_t)p_cur.x - (p_prev ? p_prev->x : 0));
+	put_zigzag(r_out, (int64_t)p_cur.y - (p_prev ? p_prev->y : 0));
+	put_zigzag(r_out, p_cur.flame_range);
+}
+
+static void read_fields(ByteReader &r_reader, StreamBomb &r_entity) {
+	r_entity.x += (int32_t)r_reader.zigzag();
+	r_entity.y += (int32_t)r_reader.zigzag();
+	r_entity.flame_range = (int32_t)r_reader.zigzag();
+}
+
+static bool same_fields(const StreamBomb &a, const StreamBomb &b) {
+	return a.x == b.x && a.y == b.y && a.flame_range == b.flame_range;
+}
+
+static void write_fields(std::vector<uint8_t> &r_out, const StreamPowerUp *p_prev, const StreamPowerUp &p_cur) {
+	put_zigzag(r_out, (int64_t)p_cur.x - (p_prev ? p_prev->x : 0));
+	put_zigzag(r_out, (int64_t)p_cur.y - (p_prev ? p_prev->y : 0));
+	put_zigzag(r_out, p_cur.type);
+}
+
+static void read_fields(ByteReader &r_reader, StreamPowerUp &r_entity) {
+	r_entity.x += (int32_t)r_reader.zigzag();
+	r_entity.y += (int32_t)r_reader.zigzag();
+	r_entity.type = (int32_t)r_reader.zigzag();
+}
+
+static bool same_fields(const StreamPowerUp &a, const StreamPowerUp &b) {
+	return a.x == b.x && a.y == b.y && a.type == b.type;
+}
+
+template <typename T>
+static bool id_less(const T &a, const T &b) {
+	return a.id < b.id;
+}
+
+/** Keyframe list: count, then (id gap, fields) for every entity. */
+template <typename T>
+static void write_entity_list(std::vector<uint8_t> &r_out, const std::vector<T> &p_entities) {
+	put_varint(r_out, p_entities.size());
+	int64_t prev_id = 0;
+	for (const T &e : p_entities) {
+		put_varint(r_out, (uint64_t)(e.id - prev_id));
+		prev_id = e.id;
+		write_fields(r_out, (const T *)nullptr, e);
+	}
+}
+
+template <typename T>
+static bool read_entity_list(ByteReader &r_reader, std::vector<T> &r_entities) {
+	r_entities.clear();
+	uint64_t count = r_reader.varint();
+	if (count > (uint64_t)(r_reader.end - r_reader.ptr)) return false;
+	int64_t id = 0;
+	for (uint64_t i = 0; i < count && r_reader.ok; i++) {
+		T e;
+		e.x = 0;
+		e.y = 0;
+		id += (int64_t)r_reader.varint();
+		e.id = id;
+		read_fields(r_reader, e);
+		r_entities.push_back(e);
+	}
+	return r_reader.ok;
+}
+
+/**
+ * Delta list between two id-sorted vectors: upserts (new or changed, fields relative to the
+ * previous value) followed by removals (ids only).
+ */
+template <typename T>
+static void write_entity_delta(std::vector<uint8_t> &r_out, const std::vector<T> &p_prev, const std::vector<T> &p_cur) {
+	for (int pass = 0; pass < 2; pass++) {
+		// Pass 0: upserts, pass 1: removals. Each pass counts first, then writes.
+		for (int emit = 0; emit < 2; emit++) {
+			uint64_t count = 0;
+			int64_t prev_id = 0;
+			size_t i = 0;
+			size_t j = 0;
+			while (i < p_prev.size() || j < p_cur.size()) {
+				const T *before = nullptr;
+				const T *after = nullptr;
+				if (j >= p_cur.size() || (i < p_prev.size() && p_prev[i].id < p_cur[j].id)) {
+					before = &p_prev[i++];
+				} else if (i >= p_prev.size() || p_cur[j].id < p_prev[i].id) {
+					after = &p_cur[j++];
+				} else {
+					before = &p_prev[i++];
+					after = &p_cur[j++];
+				}
+				bool selected = pass == 0 ? (after && (!before || !same_fields(*before, *after))) : (before && !after);
+				if (!selected) continue;
+				count++;
+				if (emit) {
+					int64_t id = pass == 0 ? after->id : before->id;
+					put_varint(r_out, (uint64_t)(id - prev_id));
+					prev_id = id;
+					if (pass == 0) write_fields(r_out, before, *after);
+				}
+			}
+			if (!emit) put_varint(r_out, count);
+		}
+	}
+}
+
+template <typename T>
+static bool read_entity_delta(ByteReader &r_reader, std::vector<T> &r_entities) {
+	uint64_t upserts = r_reader.varint();
+	int64_t id = 0;
+	for (uint64_t i = 0; i < upserts && r_reader.ok; i++) {
+		id += (int64_t)r_reader.varint();
+		T key;
+		key.id = id;
+		typename std::vector<T>::iterator it = std::lower_bound(r_entities.begin(), r_entities.end(), key, id_less<T>);
+		if (it == r_entities.end() || it->id != id) {
+			T e;
+			e.id = id;
+			e.x = 0;
+			e.y = 0;
+			it = r_entities.insert(it, e);
+		}
+		read_fields(r_reader, *it);
+	}
+	uint64_t removals = r_reader.varint();
+	id = 0;
+	for (uint64_t i = 0; i < removals && r_reader.ok; i++) {
+		id += (int64_t)r_reader.varint();
+		T key;
+		key.id = id;
+		typename std::vector<T>::iterator it = std::lower_bound(r_entities.begin(), r_entities.end(), key, id_less<T>);
+		if (it == r_entities.end() || it->id != id) return false;
+		r_entities.erase(it);
+	}
+	return r_reader.ok;
+}
+
+// --- Encoder -----------------------------------------------------------------------------
+
+StateDeltaEncoder::StateDeltaEncoder(uint32_t p_keyframe_interval) :
+		keyframe_interval(p_keyframe_interval > 0 ? p_keyframe_interval : 1) {}
+
+void StateDeltaEncoder::write_header(std::vector<uint8_t> &r_out, uint32_t p_keyframe_interval) {
+	r_out.insert(r_out.end(), STREAM_MAGIC, STREAM_MAGIC + 4);
+	put_varint(r_out, STATE_STREAM_VERSION);
+	put_varint(r_out, p_keyframe_interval);
+}
+
+void StateDeltaEncoder::force_keyframe() {
+	has_previous = false;
+}
+
+void StateDeltaEncoder::_encode_keyframe() {
+	put_varint(payload, current.tick);
+	put_varint(payload, (uint64_t)current.width);
+	put_varint(payload, (uint64_t)current.height);
+	// Run-length coded tiles: (run length, value) pairs.
+	size_t i = 0;
+	while (i < current.tiles.size()) {
+		uint8_t value = current.tiles[i];
+		size_t run = 1;
+		while (i + run < current.tiles.size() && current.tiles[i + run] == value) run++;
+		put_varint(payload, run);
+		payload.push_back(value);
+		i += run;
+	}
+	write_entity_list(payload, current.players);
+	write_entity_list(payload, current.bombs);
+	write_entity_list(payload, current.power_ups);
+}
+
+void StateDeltaEncoder::_encode_delta() {
+	put_varint(payload, current.tick - previous.tick);
+	uint64_t changed = 0;
+	for (size_t i = 0; i < current.tiles.size(); i++) {
+		if (current.tiles[i] != previous.tiles[i]) changed++;
+	}
+	put_varint(payload, changed);
+	size_t prev_index = 0;
+	for (size_t i = 0; i < current.tiles.size(); i++) {
+		if (current.tiles[i] == previous.tiles[i]) continue;
+		put_varint(payload, i - prev_index);
+		prev_index = i;
+		payload.push_back(current.tiles[i]);
+	}
+	write_entity_delta(payload, previous.players, current.players);
+	write_entity_delta(payload, previous.bombs, current.bombs);
+	write_entity_delta(payload, previous.power_ups, current.power_ups);
+}
+
+StreamRecordType StateDeltaEncoder::encode(const MatchSnapshot &p_snapshot, std::vector<uint8_t> &r_out) {
+	// Copy-assign into the scratch snapshot: vector storage is reused after the first ticks.
+	current.tick = p_snapshot.tick;
+	current.width = p_snapshot.width;
+	current.height = p_snapshot.height;
+	current.tiles = p_snapshot.tiles;
+	current.tiles.resize((size_t)std::max(current.width, 0) * (size_t)std::max(current.height, 0), 0);
+	current.players = p_snapshot.players;
+	current.bombs = p_snapshot.bombs;
+	current.power_ups = p_snapshot.power_ups;
+	std::sort(current.players.begin(), current.players.end(), id_less<StreamPlayer>);
+	std::sort(current.bombs.begin(), current.bombs.end(), id_less<StreamBomb>);
+	std::sort(current.power_ups.begin(), current.power_ups.end(), id_less<StreamPowerUp>);
+
+	bool keyframe = !has_previous || ticks_since_keyframe >= keyframe_interval ||
+			current.width != previous.width || current.height != previous.height ||
+			current.tick < previous.tick;
+
+	payload.clear();
+	StreamRecordType type;
+	if (keyframe) {
+		_encode_keyframe();
+		type = STREAM_RECORD_KEYFRAME;
+		ticks_since_keyframe = 0;
+	} else {
+		_encode_delta();
+		type = STREAM_RECORD_DELTA;
+	}
+	ticks_since_keyframe++;
+
+	r_out.push_back((uint8_t)type);
+	put_varint(r_out, payload.size());
+	r_out.insert(r_out.end(), payload.begin(), payload.end());
+
+	std::swap(previous, current);
+	has_previous = true;
+	return type;
+}
+
+// --- FileByteSource ----------------------------------------------------------------------
+
+size_t FileByteSource::read(uint8_t *r_dst, size_t p_size) {
+	size_t n = std::fread(r_dst, 1, p_size, file);
+	if (n < p_size) {
+		// Clear EOF so a tailing reader sees bytes appended later.
+		std::clearerr(file);
+	}
+	return n;
+}
+
+bool FileByteSource::seek(uint64_t p_position) {
+	return std::fseek(file, (long)p_position, SEEK_SET) == 0;
+}
+
+uint64_t FileByteSource::position() const {
+	long pos = std::ftell(file);
+	return pos < 0 ? 0 : (uint64_t)pos;
+}
+
+// --- Decoder -----------------------------------------------------------------------------
+
+StateDeltaDecoder::StateDeltaDecoder(ByteSource *p_source) :
+		source(p_source) {}
+
+StateDeltaDecoder::Result StateDeltaDecoder::read_header() {
+	if (!source->seek(0)) return RESULT_CORRUPT;
+	uint8_t header[4 + 10 + 10];
+	size_t n = source->read(header, sizeof(header));
+	if (n < 4) return n == 0 ? RESULT_END : RESULT_INCOMPLETE;
+	if (std::memcmp(header, STREAM_MAGIC, 4) != 0) return RESULT_CORRUPT;
+	ByteReader reader(header + 4, n - 4);
+	uint64_t version = reader.varint();
+	uint64_t interval = reader.varint();
+	if (!reader.ok) return RESULT_INCOMPLETE;
+	if (version != STATE_STREAM_VERSION) return RESULT_CORRUPT;
+	keyframe_interval = (uint32_t)interval;
+	data_start = (uint64_t)(reader.ptr - header);
+	has_header = true;
+	has_keyframe = false;
+	return source->seek(data_start) ? RESULT_OK : RESULT_CORRUPT;
+}
+
+StateDeltaDecoder::Result StateDeltaDecoder::_read_record(StreamRecordType &r_type) {
+	uint64_t start = source->position();
+	uint8_t head[11];
+	size_t n = source->read(head, sizeof(head));
+	if (n == 0) {
+		// Seeking back also clears a sticky EOF so a tailing reader picks up appended records.
+		source->seek(start);
+		return RESULT_END;
+	}
+	ByteReader reader(head + 1, n - 1);
+	uint64_t length = reader.varint();
+	if (!reader.ok) {
+		source->seek(start);
+		return n < sizeof(head) ? RESULT_INCOMPLETE : RESULT_CORRUPT;
+	}
+	if ((head[0] != STREAM_RECORD_KEYFRAME && head[0] != STREAM_RECORD_DELTA) || length > MAX_RECORD_SIZE) {
+		source->seek(start);
+		return RESULT_CORRUPT;
+	}
+	r_type = (StreamRecordType)head[0];
+	uint64_t payload_start = start + 1 + (uint64_t)(reader.ptr - (head + 1));
+	record.resize((size_t)length);
+	source->seek(payload_start);
+	if (source->read(record.data(), record.size()) < record.size()) {
+		source->seek(start);
+		return RESULT_INCOMPLETE;
+	}
+	return RESULT_OK;
+}
+
+bool StateDeltaDecoder::_apply_keyframe() {
+	ByteReader reader(record.data(), record.size());
+	state.tick = reader.varint();
+	uint64_t width = reader.varint();
+	uint64_t height = reader.varint();
+	// Each side is checked first so the product cannot overflow.
+	if (!reader.ok || width > STATE_STREAM_MAX_TILES || height > STATE_STREAM_MAX_TILES || width * height > STATE_STREAM_MAX_TILES) {
+		return false;
+	}
+	uint64_t count = width * height;
+	// Check the runs cover exactly count valid tiles within this record before allocating anything.
+	ByteReader scan = reader;
+	uint64_t covered = 0;
+	while (covered < count && scan.ok) {
+		uint64_t run = scan.varint();
+		uint8_t value = scan.byte();
+		if (run == 0 || run > count - covered || value > TILE_DESTRUCTIBLE) return false;
+		covered += run;
+	}
+	if (!scan.ok) return false;
+	state.width = (int)width;
+	state.height = (int)height;
+	state.tiles.resize((size_t)count);
+	size_t filled = 0;
+	while (filled < state.tiles.size()) {
+		uint64_t run = reader.varint();
+		uint8_t value = reader.byte();
+		std::memset(state.tiles.data() + filled, value, (size_t)run);
+		filled += (size_t)run;
+	}
+	return reader.ok && read_entity_list(reader, state.players) && read_entity_list(reader, state.bombs) &&
+			read_entity_list(reader, state.power_ups);
+}
+
+bool StateDeltaDecoder::_apply_delta() {
+	ByteReader reader(record.data(), record.size());
+	state.tick += reader.varint();
+	uint64_t changed = reader.varint();
+	size_t index = 0;
+	for (uint64_t i = 0; i < changed && reader.ok; i++) {
+		index += (size_t)reader.varint();
+		uint8_t value = reader.byte();
+		if (index >= state.tiles.size() || value > TILE_DESTRUCTIBLE) return false;
+		state.tiles[index] = value;
+	}
+	return reader.ok && read_entity_delta(reader, state.players) && read_entity_delta(reader, state.bombs) &&
+			read_entity_delta(reader, state.power_ups);
+}
+
+StateDeltaDecoder::Result StateDeltaDecoder::next(StreamRecordType *r_type) {
+	if (!has_header) {
+		Result header = read_header();
+		if (header != RESULT_OK) return header;
+	}
+	StreamRecordType type;
+	Result result = _read_record(type);
+	if (result != RESULT_OK) return result;
+	bool applied;
+	if (type == STREAM_RECORD_KEYFRAME) {
+		applied = _apply_keyframe();
+		has_keyframe = applied;
+	} else {
+		applied = has_keyframe && _apply_delta();
+	}
+	if (!applied) return RESULT_CORRUPT;
+	if (r_type) *r_type = type;
+	return RESULT_OK;
+}
+
+StateDeltaDecoder::Result StateDeltaDecoder::seek_keyframe(uint32_t p_index) {
+	Result header = read_header();
+	if (header != RESULT_OK) return header;
+	uint32_t seen = 0;
+	while (true) {
+		// Read only the record head; skip payloads of records we do not need.
+		uint64_t start = source->position();
+		uint8_t head[11];
+		size_t n = source->read(head, sizeof(head));
+		if (n == 0) {
+			source->seek(start);
+			return RESULT_END;
+		}
+		ByteReader reader(head + 1, n - 1);
+		uint64_t length = reader.varint();
+		if (!reader.ok) {
+			source->seek(start);
+			return n < sizeof(head) ? RESULT_INCOMPLETE : RESULT_CORRUPT;
+		}
+		uint64_t next_record = start + 1 + (uint64_t)(reader.ptr - (head + 1)) + length;
+		if (head[0] == STREAM_RECORD_KEYFRAME) {
+			if (seen == p_index) {
+				source->seek(start);
+				StreamRecordType type;
+				Result result = _read_record(type);
+				if (result != RESULT_OK) return result;
+				has_keyframe = _apply_keyframe();
+				return has_keyframe ? RESULT_OK : RESULT_CORRUPT;
+			}
+			seen++;
+		} else if (head[0] != STREAM_RECORD_DELTA) {
+			return RESULT_CORRUPT;
+		}
+		if (!source->seek(next_record)) return RESULT_INCOMPLETE;
+	}
+}
+
+} // namespace bomberman
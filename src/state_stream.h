@@ -0,0 +1,168 @@
+#ifndef BOMBERMAN_STATE_STREAM_H
+#define BOMBERMAN_STATE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace bomberman {
+
+/**
+ * Spectator / archive stream of match state. Engine-independent.
+ *
+ * File: "BMDS", varint version, varint keyframe_interval, then records:
+ *   u8 type (StreamRecordType), varint payload_length, payload.
+ * Records are length-prefixed so a reader tailing a live file can tell a half-written
+ * record from a complete one. Keyframes hold the full state (tiles run-length coded);
+ * deltas hold only changed tiles (TileType values; anything else is corrupt), moved/died players and spawned/removed bombs and
+ * power-ups. Integers are varints; coordinates are zigzag deltas; entity ids and tile
+ * indices are gap-coded in ascending order.
+ */
+
+static constexpr uint32_t STATE_STREAM_VERSION = 1;
+/** Largest width * height a stream may carry; decoders reject bigger keyframes before allocating. */
+static constexpr uint64_t STATE_STREAM_MAX_TILES = 1024u * 1024u;
+
+enum StreamRecordType : uint8_t {
+	STREAM_RECORD_KEYFRAME = 1,
+	STREAM_RECORD_DELTA = 2,
+};
+
+struct StreamPlayer {
+	int64_t id = 0;
+	int32_t x = 0;
+	int32_t y = 0;
+	bool alive = true;
+};
+
+struct StreamBomb {
+	int64_t id = 0;
+	int32_t x = 0;
+	int32_t y = 0;
+	int32_t flame_range = 1;
+};
+
+struct StreamPowerUp {
+	int64_t id = 0;
+	int32_t x = 0;
+	int32_t y = 0;
+	int32_t type = 0;
+};
+
+/** Visual state of one tick. Entity ids must be unique and non-negative (e.g. registry handles). */
+struct MatchSnapshot {
+	uint64_t tick = 0;
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> tiles;
+	std::vector<StreamPlayer> players;
+	std::vector<StreamBomb> bombs;
+	std::vector<StreamPowerUp> power_ups;
+
+	void clear_entities() {
+		players.clear();
+		bombs.clear();
+		power_ups.clear();
+	}
+};
+
+/**
+ * Turns successive snapshots into records. Keeps only the previous tick's state, so memory is
+ * bounded by the map and live entity count; buffers are reused after warm-up.
+ */
+class StateDeltaEncoder {
+private:
+	uint32_t keyframe_interval;
+	uint32_t ticks_since_keyframe = 0;
+	bool has_previous = false;
+	MatchSnapshot previous;
+	MatchSnapshot current;
+	std::vector<uint8_t> payload;
+
+	void _encode_keyframe();
+	void _encode_delta();
+
+public:
+	/** A keyframe is written every p_keyframe_interval records (minimum 1). */
+	explicit StateDeltaEncoder(uint32_t p_keyframe_interval = 300);
+
+	static void write_header(std::vector<uint8_t> &r_out, uint32_t p_keyframe_interval);
+
+	/** Appends one record describing p_snapshot to r_out and returns its type. */
+	StreamRecordType encode(const MatchSnapshot &p_snapshot, std::vector<uint8_t> &r_out);
+	/** Next encode() writes a keyframe regardless of the interval. */
+	void force_keyframe();
+
+	uint32_t get_keyframe_interval() const { return keyframe_interval; }
+};
+
+/** Random-access byte input for the decoder (file, memory, engine FileAccess, ...). */
+class ByteSource {
+public:
+	virtual ~ByteSource() {}
+	/** Reads up to p_size bytes; returns how many were available. */
+	virtual size_t read(uint8_t *r_dst, size_t p_size) = 0;
+	virtual bool seek(uint64_t p_position) = 0;
+	virtual uint64_t position() const = 0;
+};
+
+/** ByteSource over a stdio FILE opened for binary reading (not owned). */
+class FileByteSource : public ByteSource {
+private:
+	FILE *file;
+
+public:
+	explicit FileByteSource(FILE *p_file) :
+			file(p_file) {}
+	size_t read(uint8_t *r_dst, size_t p_size) override;
+	bool seek(uint64_t p_position) override;
+	uint64_t position() const override;
+};
+
+/**
+ * Rebuilds MatchSnapshot state from a stream, one record at a time. Holds only the current
+ * state and one record buffer, so memory does not grow with match length. A reader can tail
+ * a file that is still being written: RESULT_INCOMPLETE leaves the position at the start of
+ * the partial record so next() can simply be called again later.
+ */
+class StateDeltaDecoder {
+public:
+	enum Result {
+		RESULT_OK,
+		RESULT_END, // no bytes after the last complete record
+		RESULT_INCOMPLETE, // partial record; retry once more data has been written
+		RESULT_CORRUPT,
+	};
+
+private:
+	ByteSource *source;
+	uint64_t data_start = 0;
+	uint32_t keyframe_interval = 0;
+	bool has_header = false;
+	bool has_keyframe = false;
+	MatchSnapshot state;
+	std::vector<uint8_t> record;
+
+	Result _read_record(StreamRecordType &r_type);
+	bool _apply_keyframe();
+	bool _apply_delta();
+
+public:
+	explicit StateDeltaDecoder(ByteSource *p_source);
+
+	Result read_header();
+	/** Reads and applies the next record. Deltas before the first keyframe are rejected as corrupt. */
+	Result next(StreamRecordType *r_type = nullptr);
+	/** Rewinds and applies the p_index-th keyframe (0-based), skipping deltas without decoding. */
+	Result seek_keyframe(uint32_t p_index);
+
+	const MatchSnapshot &get_state() const { return state; }
+	uint32_t get_keyframe_interval() const { return keyframe_interval; }
+	/** False until the first keyframe has been applied. */
+	bool has_state() const { return has_keyframe; }
+};
+
+} // namespace bomberman
+
+#endif // BOMBERMAN_STATE_STREAM_H
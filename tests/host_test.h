@@ -0,0 +1,43 @@
+#ifndef BOMBERMAN_HOST_TEST_H
+#define BOMBERMAN_HOST_TEST_H
+
+#include <cstdio>
+
+// Minimal self-registering test harness; no third-party framework needed.
+
+namespace host_test {
+
+typedef void (*TestFunction)();
+
+struct TestCase {
+	const char *name;
+	TestFunction function;
+	TestCase *next;
+};
+
+/** Registers a test at static-initialization time. */
+struct Registrar {
+	Registrar(TestCase *p_case);
+};
+
+/** Counts a failed CHECK in the running test. */
+void fail(const char *p_file, int p_line, const char *p_expression);
+
+} // namespace host_test
+
+#define HOST_TEST(m_name)                                                          \
+	static void m_name();                                                          \
+	static host_test::TestCase m_name##_case = { #m_name, &m_name, nullptr };      \
+	static host_test::Registrar m_name##_registrar(&m_name##_case);                \
+	static void m_name()
+
+/** Records a failure and returns from the test. */
+#define CHECK(m_cond)                                          \
+	do {                                                       \
+		if (!(m_cond)) {                                       \
+			host_test::fail(__FILE__, __LINE__, #m_cond);      \
+			return;                                            \
+		}                                                      \
+	} while (0)
+
+#endif // BOMBERMAN_HOST_TEST_H
@@ -0,0 +1,41 @@
+// Runs every HOST_TEST and exits non-zero if any of them failed.
+
+#include "host_test.h"
+
+namespace host_test {
+
+static TestCase *first_case = nullptr;
+static TestCase *last_case = nullptr;
+static int failures = 0;
+
+Registrar::Registrar(TestCase *p_case) {
+	// Keep registration order (file order within a translation unit).
+	if (last_case) {
+		last_case->next = p_case;
+	} else {
+		first_case = p_case;
+	}
+	last_case = p_case;
+}
+
+void fail(const char *p_file, int p_line, const char *p_expression) {
+	std::printf("    %s:%d: CHECK(%s) failed\n", p_file, p_line, p_expression);
+	failures++;
+}
+
+} // namespace host_test
+
+int main() {
+	int run = 0;
+	int failed = 0;
+	for (host_test::TestCase *c = host_test::first_case; c; c = c->next) {
+		int before = host_test::failures;
+		c->function();
+		run++;
+		bool ok = host_test::failures == before;
+		if (!ok) failed++;
+		std::printf("%s %s\n", ok ? "[ OK ]" : "[FAIL]", c->name);
+	}
+	std::printf("%d tests, %d failed\n", run, failed);
+	return failed == 0 ? 0 : 1;
+}
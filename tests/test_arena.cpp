@@ -0,0 +1,119 @@
+// Arena / FrameArena: chunk folding on reset(), no mallocs in steady state, the lazy frame
+// counter and the FrameAllocator escape guard (built with DEBUG_ENABLED, see SConstruct).
+
+#include "host_test.h"
+
+#include "arena.h"
+#include "frame_arena.h"
+
+#include <cstring>
+#include <string>
+
+using namespace bomberman;
+
+HOST_TEST(reset_folds_overflow_chunks_into_one) {
+	Arena arena(256);
+	for (int i = 0; i < 3; i++) {
+		CHECK(arena.allocate(200) != nullptr);
+	}
+	CHECK(arena.get_chunk_allocations() == 3);
+	CHECK(arena.get_bytes_reserved() == 3 * 256);
+
+	arena.reset();
+	// One chunk covering everything the overflowing frame reserved.
+	CHECK(arena.get_chunk_allocations() == 4);
+	CHECK(arena.get_bytes_reserved() == 3 * 256);
+	CHECK(arena.get_bytes_used() == 0);
+	CHECK(arena.get_frame_index() == 1);
+
+	// The same frame now fits without another malloc, and so does every later one.
+	for (int frame = 0; frame < 10; frame++) {
+		for (int i = 0; i < 3; i++) {
+			CHECK(arena.allocate(200) != nullptr);
+		}
+		arena.reset();
+	}
+	CHECK(arena.get_chunk_allocations() == 4);
+	CHECK(arena.get_bytes_reserved() == 3 * 256);
+	CHECK(arena.get_peak_bytes_used() <= 3 * 256);
+}
+
+HOST_TEST(frame_vectors_stop_allocating_chunks_after_warm_up) {
+	FrameArena::end_frame();
+	Arena &arena = FrameArena::get();
+
+	auto run_frame = [](int p_count) {
+		FrameVector<int> cells;
+		for (int i = 0; i < p_count; i++) {
+			cells.push_back(i);
+		}
+		FrameVector<char> text(p_count * 3, 'x');
+	};
+
+	// Warm up with the largest frame, then vary the frame size below it.
+	run_frame(20000);
+	FrameArena::end_frame();
+	uint64_t chunk_allocations = arena.get_chunk_allocations();
+	size_t bytes_reserved = arena.get_bytes_reserved();
+
+	for (int frame = 0; frame < 1000; frame++) {
+		run_frame((frame * 7919) % 20000);
+		FrameArena::end_frame();
+	}
+	CHECK(arena.get_chunk_allocations() == chunk_allocations);
+	CHECK(arena.get_bytes_reserved() == bytes_reserved);
+}
+
+static uint64_t fake_frame = 0;
+
+static uint64_t fake_frame_counter() {
+	return fake_frame;
+}
+
+HOST_TEST(frame_counter_resets_without_end_frame) {
+	FrameArena::end_frame();
+	FrameArena::set_frame_counter(&fake_frame_counter);
+
+	Arena &arena = FrameArena::get();
+	uint64_t frame_index = arena.get_frame_index();
+	arena.allocate(64);
+	CHECK(FrameArena::get().get_bytes_used() > 0); // same frame: kept
+
+	fake_frame++;
+	CHECK(FrameArena::get().get_bytes_used() == 0);
+	CHECK(arena.get_frame_index() == frame_index + 1);
+
+	// An empty arena is left alone when the counter moves on.
+	fake_frame++;
+	FrameArena::get();
+	CHECK(arena.get_frame_index() == frame_index + 1);
+
+	FrameArena::set_frame_counter(nullptr);
+}
+
+static int escape_errors = 0;
+static std::string last_escape_error;
+
+static void record_escape_error(const char *p_message) {
+	escape_errors++;
+	last_escape_error = p_message;
+}
+
+HOST_TEST(frame_vector_used_after_end_frame_is_reported) {
+	FrameArena::set_error_handler(&record_escape_error);
+	escape_errors = 0;
+	{
+		FrameArena::end_frame();
+		FrameVector<int> cells;
+		cells.push_back(1);
+		cells.push_back(2);
+		CHECK(escape_errors == 0); // used within its frame
+
+		FrameArena::end_frame();
+		cells.resize(64); // outgrows its buffer: allocates after the reset
+		CHECK(escape_errors > 0);
+		CHECK(last_escape_error.find("after reset") != std::string::npos);
+	}
+	FrameArena::set_error_handler(nullptr);
+	CHECK(escape_errors > 0);
+}
@@ -0,0 +1,103 @@
+// EntityPool: stale and foreign-kind handles, dense storage after swap-and-pop and the
+// generation wrap.
+
+#include "host_test.h"
+
+#include "entity_registry.h"
+
+#include <vector>
+
+using namespace godot;
+
+static uint32_t generation_of(EntityHandle p_handle) {
+	return (uint32_t)(((uint64_t)p_handle >> 32) & 0xFFFFFF);
+}
+
+HOST_TEST(destroyed_handles_go_stale) {
+	EntityPool<int> pool(ENTITY_KIND_BOMB);
+	EntityHandle a = pool.create(1);
+	CHECK(a != INVALID_ENTITY_HANDLE);
+	CHECK(pool.is_valid(a));
+	CHECK(pool.get(a) && *pool.get(a) == 1);
+
+	CHECK(pool.destroy(a));
+	CHECK(!pool.is_valid(a));
+	CHECK(pool.get(a) == nullptr);
+	CHECK(!pool.destroy(a));
+
+	// The recycled slot gets a new generation, so the old handle stays stale.
+	EntityHandle b = pool.create(2);
+	CHECK(b != a);
+	CHECK(!pool.is_valid(a));
+	CHECK(pool.get(b) && *pool.get(b) == 2);
+
+	CHECK(!pool.is_valid(INVALID_ENTITY_HANDLE));
+	CHECK(!pool.is_valid(-1));
+}
+
+HOST_TEST(handles_of_another_kind_are_rejected) {
+	EntityPool<int> bombs(ENTITY_KIND_BOMB);
+	EntityPool<int> players(ENTITY_KIND_PLAYER);
+	EntityHandle bomb = bombs.create(1);
+	EntityHandle player = players.create(2);
+
+	CHECK(entity_kind_of(bomb) == ENTITY_KIND_BOMB);
+	CHECK(entity_kind_of(player) == ENTITY_KIND_PLAYER);
+	CHECK(entity_kind_of(INVALID_ENTITY_HANDLE) == ENTITY_KIND_NONE);
+
+	// Same slot and generation, different kind.
+	CHECK(!players.is_valid(bomb));
+	CHECK(players.get(bomb) == nullptr);
+	CHECK(!players.destroy(bomb));
+	CHECK(bombs.is_valid(bomb));
+	CHECK(!bombs.is_valid(player));
+}
+
+HOST_TEST(swap_and_pop_keeps_handles_resolving) {
+	EntityPool<int> pool(ENTITY_KIND_POWER_UP);
+	std::vector<EntityHandle> handles;
+	for (int i = 0; i < 8; i++) {
+		handles.push_back(pool.create(i));
+	}
+
+	// Destroy from the front, the middle and the back; the last value moves into each hole.
+	CHECK(pool.destroy(handles[0]));
+	CHECK(pool.destroy(handles[4]));
+	CHECK(pool.destroy(handles[7]));
+	CHECK(pool.size() == 5);
+
+	for (int i = 0; i < 8; i++) {
+		bool destroyed = i == 0 || i == 4 || i == 7;
+		CHECK(pool.is_valid(handles[i]) == !destroyed);
+		if (!destroyed) {
+			CHECK(pool.get(handles[i]) && *pool.get(handles[i]) == i);
+		}
+	}
+	// Dense iteration sees each live value once, with its own handle.
+	for (size_t d = 0; d < pool.size(); d++) {
+		EntityHandle handle = pool.handle_at(d);
+		CHECK(pool.get(handle) == &pool.at(d));
+		CHECK(handle == handles[pool.at(d)]);
+	}
+}
+
+HOST_TEST(generation_skips_zero_on_wrap) {
+	EntityPool<int> pool(ENTITY_KIND_BOMB);
+	EntityHandle first = pool.create(0);
+	CHECK(generation_of(first) == 1);
+	CHECK(pool.destroy(first));
+
+	// Cycle the one slot through every 24-bit generation.
+	EntityHandle handle = INVALID_ENTITY_HANDLE;
+	for (uint32_t i = 1; i < 0xFFFFFF; i++) {
+		handle = pool.create(0);
+		CHECK(generation_of(handle) != 0);
+		CHECK(pool.destroy(handle));
+	}
+	CHECK(generation_of(handle) == 0xFFFFFF);
+
+	handle = pool.create(0);
+	CHECK(generation_of(handle) == 1);
+	CHECK(entity_kind_of(handle) == ENTITY_KIND_BOMB);
+	CHECK(pool.is_valid(handle));
+}
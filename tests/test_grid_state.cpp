@@ -0,0 +1,108 @@
+// Blast reach tables (GridState) against a cell-by-cell reference walk.
+
+#include "host_test.h"
+
+#include "grid_state.h"
+
+#include <cstring>
+#include <random>
+
+using namespace bomberman;
+
+static const char *TEST_MAP =
+		"###################\n"
+		"#.................#\n"
+		"#.xxx.xxx.xxx.xxx.#\n"
+		"#.................#\n"
+		"#.xxx.xxx.xxx.xxx.#\n"
+		"#.................#\n"
+		"#.xxx.xxx.xxx.xxx.#\n"
+		"#.................#\n"
+		"###################\n";
+
+/** Reference rule: stop before a wall, include the first destructible tile, then stop. */
+static int walk_blast_extent(const GridState &p_grid, int x, int y, int dx, int dy, int p_range) {
+	int extent = 0;
+	for (int d = 1; d <= p_range; d++) {
+		int tile = p_grid.get_tile(x + dx * d, y + dy * d);
+		if (tile == TILE_WALL) break;
+		extent = d;
+		if (tile == TILE_DESTRUCTIBLE) break;
+	}
+	return extent;
+}
+
+/** Compares blast_extent with the walk from every cell (and a ring outside), all directions. */
+static bool matches_reference(const GridState &p_grid, int p_range) {
+	for (int y = -1; y <= p_grid.get_height(); y++) {
+		for (int x = -1; x <= p_grid.get_width(); x++) {
+			for (int dir = 0; dir < BLAST_DIRECTION_COUNT; dir++) {
+				int dx = BLAST_DIR_DX[dir];
+				int dy = BLAST_DIR_DY[dir];
+				if (p_grid.blast_extent(x, y, dx, dy, p_range) != walk_blast_extent(p_grid, x, y, dx, dy, p_range)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+HOST_TEST(reach_tables_match_walk_after_load) {
+	GridState grid(19, 9);
+	grid.load_from_string(TEST_MAP, std::strlen(TEST_MAP));
+	CHECK(grid.get_tile(0, 0) == TILE_WALL);
+	CHECK(grid.get_tile(2, 2) == TILE_DESTRUCTIBLE);
+	CHECK(matches_reference(grid, 1));
+	CHECK(matches_reference(grid, 5));
+	CHECK(matches_reference(grid, 40));
+}
+
+HOST_TEST(reach_tables_match_walk_under_random_edits) {
+	std::mt19937 rng(3);
+	GridState grid(19, 9);
+	grid.load_from_string(TEST_MAP, std::strlen(TEST_MAP));
+	for (int step = 0; step < 4000; step++) {
+		// Includes out-of-bounds writes (ignored) and a value outside TileType (blast passes).
+		int x = (int)(rng() % 23) - 2;
+		int y = (int)(rng() % 13) - 2;
+		grid.set_tile(x, y, (int)(rng() % 4));
+		if (step % 500 == 499) {
+			grid.resize(15 + (int)(rng() % 10), 5 + (int)(rng() % 10));
+		}
+		for (int q = 0; q < 20; q++) {
+			int ox = (int)(rng() % (unsigned)(grid.get_width() + 2)) - 1;
+			int oy = (int)(rng() % (unsigned)(grid.get_height() + 2)) - 1;
+			int range = (int)(rng() % 30);
+			for (int dir = 0; dir < BLAST_DIRECTION_COUNT; dir++) {
+				int dx = BLAST_DIR_DX[dir];
+				int dy = BLAST_DIR_DY[dir];
+				CHECK(grid.blast_extent(ox, oy, dx, dy, range) == walk_blast_extent(grid, ox, oy, dx, dy, range));
+			}
+		}
+	}
+	CHECK(matches_reference(grid, 30));
+}
+
+HOST_TEST(destroy_tile_opens_rays_behind_it) {
+	GridState grid(19, 9);
+	grid.load_from_string(TEST_MAP, std::strlen(TEST_MAP));
+	// (1, 2) looks east into the destructible block at (2..4, 2).
+	CHECK(grid.blast_extent(1, 2, 1, 0, 10) == 1);
+	CHECK(grid.destroy_tile(2, 2));
+	CHECK(!grid.destroy_tile(2, 2));
+	CHECK(grid.blast_extent(1, 2, 1, 0, 10) == 2);
+	CHECK(grid.get_blast_reach(1, 2, BLAST_EAST) == 2);
+	CHECK(matches_reference(grid, 20));
+}
+
+HOST_TEST(assign_rebuilds_reach_tables) {
+	std::mt19937 rng(11);
+	std::vector<uint8_t> tiles(13 * 7);
+	for (uint8_t &t : tiles) t = (uint8_t)(rng() % 3);
+	GridState grid(19, 9);
+	grid.assign(13, 7, tiles.data());
+	CHECK(grid.get_width() == 13 && grid.get_height() == 7);
+	CHECK(std::memcmp(grid.get_tile_data(), tiles.data(), tiles.size()) == 0);
+	CHECK(matches_reference(grid, 15));
+}
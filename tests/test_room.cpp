@@ -0,0 +1,135 @@
+// Headless Room (server/room.*): explosions kill and give the bomb slot back, and ticks never
+// touch the arena after construction. TickHistogram percentiles and merge.
+
+#include "host_test.h"
+
+#include "arena.h"
+#include "room.h"
+#include "tick_histogram.h"
+
+#include <cstdint>
+
+using namespace bomberman;
+
+// 3x3 open floor: players 0, 1 and 2 spawn at (1,1), (3,3) and (3,1).
+static const char *OPEN_MAP =
+		"#####\n"
+		"#...#\n"
+		"#...#\n"
+		"#...#\n"
+		"#####\n";
+
+static PlayerInput move(int p_dx, int p_dy) {
+	PlayerInput input;
+	input.dx = (int8_t)p_dx;
+	input.dy = (int8_t)p_dy;
+	return input;
+}
+
+HOST_TEST(bomb_kills_players_in_its_blast_and_frees_the_slot) {
+	RoomConfig config;
+	config.player_count = 3;
+	config.tick_rate = 10;
+	config.bomb_time = 0.5;
+	config.map_data = OPEN_MAP;
+	config.map_width = 5;
+	config.map_height = 5;
+	Arena arena(4096);
+	Room room(config, &arena);
+
+	// Player 0 bombs (1,1) and walks out of range; player 2 walks into it.
+	PlayerInput bomb;
+	bomb.place_bomb = true;
+	room.set_input(0, bomb);
+	room.set_input(2, move(-1, 0));
+	room.tick();
+	CHECK(room.get_player(0).active_bombs == 1);
+	room.set_input(0, move(0, 1));
+	room.tick();
+	room.set_input(0, move(0, 1));
+	room.tick();
+	CHECK(room.get_player(0).grid_y == 3);
+	CHECK(room.get_player(2).grid_x == 2);
+	CHECK(room.get_player(2).is_alive);
+
+	for (int t = 0; t < 20 && room.get_player(0).active_bombs > 0; t++) {
+		room.tick();
+	}
+	CHECK(room.get_player(0).active_bombs == 0);
+	CHECK(room.get_player(0).is_alive);
+	CHECK(room.get_player(1).is_alive);
+	CHECK(!room.get_player(2).is_alive);
+	CHECK(room.get_matches_finished() == 0); // two still alive
+}
+
+HOST_TEST(room_ticks_do_not_grow_the_arena) {
+	RoomConfig config;
+	config.seed = 7;
+	Arena arena(4096);
+	Room room(config, &arena);
+	size_t bytes_used = arena.get_bytes_used();
+	size_t bytes_reserved = arena.get_bytes_reserved();
+	uint64_t chunk_allocations = arena.get_chunk_allocations();
+
+	// Random walkers bombing often enough to finish several matches.
+	uint32_t rng = 12345;
+	for (int t = 0; t < 20000; t++) {
+		for (int p = 0; p < room.get_player_count(); p++) {
+			rng = rng * 1664525u + 1013904223u;
+			int dir = (int)(rng >> 28) % 5;
+			PlayerInput input = move(dir == 1 ? 1 : dir == 2 ? -1 : 0, dir == 3 ? 1 : dir == 4 ? -1 : 0);
+			input.place_bomb = (rng >> 8) % 16 == 0;
+			room.set_input(p, input);
+		}
+		room.tick();
+	}
+	CHECK(room.get_matches_finished() > 0);
+	CHECK(arena.get_bytes_used() == bytes_used);
+	CHECK(arena.get_bytes_reserved() == bytes_reserved);
+	CHECK(arena.get_chunk_allocations() == chunk_allocations);
+}
+
+/** Bucket upper bounds overshoot by less than one sub-bucket (1/16). */
+static bool near(uint64_t p_value, uint64_t p_expected) {
+	return p_value >= p_expected && p_value <= p_expected + p_expected / 16;
+}
+
+HOST_TEST(tick_histogram_percentiles_of_a_uniform_distribution) {
+	TickHistogram empty;
+	CHECK(empty.percentile(0.5) == 0);
+
+	TickHistogram histogram;
+	for (uint64_t v = 1; v <= 1000; v++) {
+		histogram.record(v * 1000);
+	}
+	CHECK(histogram.get_count() == 1000);
+	CHECK(histogram.get_max() == 1000000);
+	CHECK(near(histogram.percentile(0.0), 1000));
+	CHECK(near(histogram.percentile(0.5), 501000));
+	CHECK(near(histogram.percentile(0.99), 991000));
+	CHECK(histogram.percentile(1.0) == 1000000); // clamped to the observed max
+
+	// Below SUB_COUNT every value has its own bucket.
+	TickHistogram small;
+	for (uint64_t v = 0; v < 10; v++) {
+		small.record(v);
+	}
+	CHECK(small.percentile(0.0) == 0);
+	CHECK(small.percentile(0.5) == 5);
+	CHECK(small.percentile(0.9) == 9);
+}
+
+HOST_TEST(tick_histogram_merge_matches_recording_everything_once) {
+	TickHistogram low, high, all;
+	for (uint64_t v = 1; v <= 1000; v++) {
+		(v <= 500 ? low : high).record(v * 1000);
+		all.record(v * 1000);
+	}
+	low.merge(high);
+	CHECK(low.get_count() == all.get_count());
+	CHECK(low.get_max() == all.get_max());
+	const double quantiles[] = { 0.0, 0.1, 0.5, 0.9, 0.99, 1.0 };
+	for (double q : quantiles) {
+		CHECK(low.percentile(q) == all.percentile(q));
+	}
+}
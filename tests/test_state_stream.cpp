@@ -0,0 +1,319 @@
+// StateDeltaEncoder / StateDeltaDecoder: round trip, keyframe seeks, tailing a live stream
+// and rejection of corrupt input.
+
+#include "host_test.h"
+
+#include "grid_state.h"
+#include "state_stream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <stdlib.h> // mkstemp
+
+using namespace bomberman;
+
+/** In-memory stream; only the first `visible` bytes can be read, like a file still being written. */
+class MemoryByteSource : public ByteSource {
+public:
+	std::vector<uint8_t> data;
+	size_t visible = 0;
+	size_t pos = 0;
+
+	size_t read(uint8_t *r_dst, size_t p_size) override {
+		size_t count = pos < visible ? std::min(p_size, visible - pos) : 0;
+		if (count > 0) std::memcpy(r_dst, data.data() + pos, count);
+		pos += count;
+		return count;
+	}
+	bool seek(uint64_t p_position) override {
+		if (p_position > visible) return false;
+		pos = (size_t)p_position;
+		return true;
+	}
+	uint64_t position() const override { return pos; }
+};
+
+template <typename T>
+static std::vector<T> sorted_by_id(std::vector<T> p_entities) {
+	std::sort(p_entities.begin(), p_entities.end(), [](const T &a, const T &b) { return a.id < b.id; });
+	return p_entities;
+}
+
+/** The decoder returns entities in id order; the encoder accepts any order. */
+static bool same_state(const MatchSnapshot &p_expected, const MatchSnapshot &p_actual) {
+	if (p_expected.tick != p_actual.tick || p_expected.width != p_actual.width || p_expected.height != p_actual.height ||
+			p_expected.tiles != p_actual.tiles) {
+		return false;
+	}
+	std::vector<StreamPlayer> players = sorted_by_id(p_expected.players);
+	std::vector<StreamBomb> bombs = sorted_by_id(p_expected.bombs);
+	std::vector<StreamPowerUp> power_ups = sorted_by_id(p_expected.power_ups);
+	if (players.size() != p_actual.players.size() || bombs.size() != p_actual.bombs.size() ||
+			power_ups.size() != p_actual.power_ups.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < players.size(); i++) {
+		const StreamPlayer &a = players[i];
+		const StreamPlayer &b = p_actual.players[i];
+		if (a.id != b.id || a.x != b.x || a.y != b.y || a.alive != b.alive) return false;
+	}
+	for (size_t i = 0; i < bombs.size(); i++) {
+		const StreamBomb &a = bombs[i];
+		const StreamBomb &b = p_actual.bombs[i];
+		if (a.id != b.id || a.x != b.x || a.y != b.y || a.flame_range != b.flame_range) return false;
+	}
+	for (size_t i = 0; i < power_ups.size(); i++) {
+		const StreamPowerUp &a = power_ups[i];
+		const StreamPowerUp &b = p_actual.power_ups[i];
+		if (a.id != b.id || a.x != b.x || a.y != b.y || a.type != b.type) return false;
+	}
+	return true;
+}
+
+/** A random match: tile edits, moves, deaths, bomb and power-up churn, and one resize. */
+static std::vector<MatchSnapshot> random_match(int p_ticks, unsigned p_seed) {
+	std::mt19937 rng(p_seed);
+	std::vector<MatchSnapshot> history;
+	MatchSnapshot s;
+	s.width = 19;
+	s.height = 9;
+	s.tiles.resize((size_t)(s.width * s.height));
+	for (uint8_t &t : s.tiles) t = (uint8_t)(rng() % 3);
+	for (int i = 0; i < 4; i++) {
+		StreamPlayer p;
+		p.id = (2ll << 56) | (1ll << 32) | i;
+		p.x = 1 + i;
+		p.y = 1;
+		s.players.push_back(p);
+	}
+	int64_t next_id = 100;
+	for (int tick = 0; tick < p_ticks; tick++) {
+		s.tick = (uint64_t)tick;
+		if (tick == p_ticks / 2) {
+			s.width = 21;
+			s.tiles.assign((size_t)(s.width * s.height), 1);
+		}
+		for (int k = 0; k < 2; k++) {
+			if (rng() % 4 == 0) s.tiles[rng() % s.tiles.size()] = (uint8_t)(rng() % 3);
+		}
+		for (StreamPlayer &p : s.players) {
+			if (rng() % 10 == 0) p.x += (int)(rng() % 3) - 1;
+			if (rng() % 500 == 0) p.alive = !p.alive;
+		}
+		if (rng() % 20 == 0) {
+			StreamBomb b;
+			b.id = (3ll << 56) | next_id++;
+			b.x = (int)(rng() % 19);
+			b.y = (int)(rng() % 9);
+			b.flame_range = 1 + (int)(rng() % 5);
+			s.bombs.push_back(b);
+		}
+		if (!s.bombs.empty() && rng() % 25 == 0) s.bombs.erase(s.bombs.begin() + rng() % s.bombs.size());
+		if (rng() % 30 == 0) {
+			StreamPowerUp u;
+			u.id = (4ll << 56) | next_id++;
+			u.x = (int)(rng() % 19);
+			u.y = -3; // negative coordinates must survive zigzag coding
+			u.type = (int)(rng() % 5);
+			s.power_ups.push_back(u);
+		}
+		if (!s.power_ups.empty() && rng() % 40 == 0) s.power_ups.erase(s.power_ups.begin() + rng() % s.power_ups.size());
+		std::shuffle(s.bombs.begin(), s.bombs.end(), rng);
+		history.push_back(s);
+	}
+	return history;
+}
+
+struct EncodedMatch {
+	std::vector<uint8_t> bytes;
+	std::vector<uint64_t> keyframe_ticks;
+};
+
+static EncodedMatch encode_match(const std::vector<MatchSnapshot> &p_history, uint32_t p_interval) {
+	EncodedMatch result;
+	StateDeltaEncoder encoder(p_interval);
+	StateDeltaEncoder::write_header(result.bytes, p_interval);
+	for (const MatchSnapshot &s : p_history) {
+		if (encoder.encode(s, result.bytes) == STREAM_RECORD_KEYFRAME) {
+			result.keyframe_ticks.push_back(s.tick);
+		}
+	}
+	return result;
+}
+
+HOST_TEST(round_trip_sequential_and_keyframe_seeks) {
+	std::vector<MatchSnapshot> history = random_match(2000, 7);
+	EncodedMatch match = encode_match(history, 120);
+	// Interval keyframes plus the one forced by the resize.
+	CHECK(match.keyframe_ticks.size() >= 2000 / 120);
+	// Deltas must keep the stream far below a full snapshot per tick.
+	CHECK(match.bytes.size() < history.size() * 64);
+
+	MemoryByteSource source;
+	source.data = match.bytes;
+	source.visible = source.data.size();
+	StateDeltaDecoder decoder(&source);
+	for (const MatchSnapshot &expected : history) {
+		CHECK(decoder.next() == StateDeltaDecoder::RESULT_OK);
+		CHECK(same_state(expected, decoder.get_state()));
+	}
+	CHECK(decoder.next() == StateDeltaDecoder::RESULT_END);
+	CHECK(decoder.get_keyframe_interval() == 120);
+
+	for (size_t k = 0; k < match.keyframe_ticks.size(); k++) {
+		CHECK(decoder.seek_keyframe((uint32_t)k) == StateDeltaDecoder::RESULT_OK);
+		CHECK(same_state(history[(size_t)match.keyframe_ticks[k]], decoder.get_state()));
+	}
+	CHECK(decoder.seek_keyframe((uint32_t)match.keyframe_ticks.size()) == StateDeltaDecoder::RESULT_END);
+
+	// Seek, then continue with deltas from there.
+	CHECK(decoder.seek_keyframe(3) == StateDeltaDecoder::RESULT_OK);
+	for (size_t t = (size_t)match.keyframe_ticks[3] + 1; t < (size_t)match.keyframe_ticks[3] + 200; t++) {
+		CHECK(decoder.next() == StateDeltaDecoder::RESULT_OK);
+		CHECK(same_state(history[t], decoder.get_state()));
+	}
+}
+
+HOST_TEST(tailing_a_stream_written_in_chunks) {
+	std::vector<MatchSnapshot> history = random_match(600, 21);
+	EncodedMatch match = encode_match(history, 60);
+	std::mt19937 rng(5);
+
+	MemoryByteSource source;
+	source.data = match.bytes;
+	StateDeltaDecoder decoder(&source);
+	size_t decoded = 0;
+	while (source.visible < source.data.size()) {
+		// The writer appends odd-sized pieces, splitting headers and records anywhere.
+		source.visible = std::min(source.data.size(), source.visible + 1 + rng() % 37);
+		while (true) {
+			StateDeltaDecoder::Result result = decoder.next();
+			CHECK(result != StateDeltaDecoder::RESULT_CORRUPT);
+			if (result != StateDeltaDecoder::RESULT_OK) break;
+			CHECK(decoded < history.size());
+			CHECK(same_state(history[decoded], decoder.get_state()));
+			decoded++;
+		}
+	}
+	CHECK(decoded == history.size());
+}
+
+HOST_TEST(tailing_a_file_through_sticky_eof) {
+	std::vector<MatchSnapshot> history = random_match(300, 33);
+	EncodedMatch match = encode_match(history, 50);
+
+	// Separate writer and reader handles, as with a recorder and a spectator. The reader hits
+	// EOF repeatedly; that must not hide data appended afterwards.
+	char path[] = "/tmp/bomberman_host_tests_XXXXXX";
+	int fd = mkstemp(path);
+	CHECK(fd >= 0);
+	FILE *writer = fdopen(fd, "wb");
+	FILE *reader = std::fopen(path, "rb");
+	std::remove(path);
+	CHECK(writer != nullptr && reader != nullptr);
+	FileByteSource source(reader);
+	StateDeltaDecoder decoder(&source);
+	size_t written = 0;
+	size_t decoded = 0;
+	bool ok = true;
+	while (written < match.bytes.size() && ok) {
+		size_t chunk = std::min(match.bytes.size() - written, (size_t)97);
+		std::fwrite(match.bytes.data() + written, 1, chunk, writer);
+		std::fflush(writer);
+		written += chunk;
+		while (true) {
+			StateDeltaDecoder::Result result = decoder.next();
+			if (result == StateDeltaDecoder::RESULT_CORRUPT) ok = false;
+			if (result != StateDeltaDecoder::RESULT_OK) break;
+			if (decoded >= history.size() || !same_state(history[decoded], decoder.get_state())) ok = false;
+			decoded++;
+		}
+	}
+	std::fclose(writer);
+	std::fclose(reader);
+	CHECK(ok);
+	CHECK(decoded == history.size());
+}
+
+static void append_record(std::vector<uint8_t> &r_bytes, uint8_t p_type, const std::vector<uint8_t> &p_payload) {
+	r_bytes.push_back(p_type);
+	size_t length = p_payload.size();
+	while (length >= 0x80) {
+		r_bytes.push_back((uint8_t)(length | 0x80));
+		length >>= 7;
+	}
+	r_bytes.push_back((uint8_t)length);
+	r_bytes.insert(r_bytes.end(), p_payload.begin(), p_payload.end());
+}
+
+/** Header followed by one record of p_type carrying p_payload. */
+static std::vector<uint8_t> stream_with_record(uint8_t p_type, const std::vector<uint8_t> &p_payload) {
+	std::vector<uint8_t> bytes;
+	StateDeltaEncoder::write_header(bytes, 10);
+	append_record(bytes, p_type, p_payload);
+	return bytes;
+}
+
+static StateDeltaDecoder::Result decode_first(const std::vector<uint8_t> &p_bytes) {
+	MemoryByteSource source;
+	source.data = p_bytes;
+	source.visible = source.data.size();
+	StateDeltaDecoder decoder(&source);
+	return decoder.next();
+}
+
+HOST_TEST(oversized_keyframe_is_rejected_before_allocating) {
+	// tick 0, width 65535, height 65535, one run covering every tile, no entities.
+	std::vector<uint8_t> payload = { 0, 0xFF, 0xFF, 0x03, 0xFF, 0xFF, 0x03, 0x81, 0x80, 0xF8, 0xFF, 0x0F, 0, 0, 0, 0 };
+	CHECK(decode_first(stream_with_record(STREAM_RECORD_KEYFRAME, payload)) == StateDeltaDecoder::RESULT_CORRUPT);
+
+	// Within the tile cap, but the runs do not cover width * height.
+	std::vector<uint8_t> short_runs = { 0, 100, 100, 10, 0, 0, 0, 0 };
+	CHECK(decode_first(stream_with_record(STREAM_RECORD_KEYFRAME, short_runs)) == StateDeltaDecoder::RESULT_CORRUPT);
+}
+
+HOST_TEST(tiles_outside_tile_type_are_rejected) {
+	// 2x1 keyframe: runs (1 x wall), (1 x 200). Such values would reach GridManager via MatchReplay.
+	std::vector<uint8_t> bad_run = { 0, 2, 1, 1, TILE_WALL, 1, 200, 0, 0, 0 };
+	CHECK(decode_first(stream_with_record(STREAM_RECORD_KEYFRAME, bad_run)) == StateDeltaDecoder::RESULT_CORRUPT);
+
+	std::vector<uint8_t> keyframe = { 0, 2, 1, 2, TILE_WALL, 0, 0, 0 };
+	std::vector<uint8_t> bytes = stream_with_record(STREAM_RECORD_KEYFRAME, keyframe);
+	// Delta: tick +1, one changed tile at index 1 set to 3, no entity changes.
+	append_record(bytes, STREAM_RECORD_DELTA, { 1, 1, 1, 3, 0, 0, 0, 0, 0, 0 });
+	MemoryByteSource source;
+	source.data = bytes;
+	source.visible = source.data.size();
+	StateDeltaDecoder decoder(&source);
+	CHECK(decoder.next() == StateDeltaDecoder::RESULT_OK);
+	CHECK(decoder.get_state().tiles == std::vector<uint8_t>({ TILE_WALL, TILE_WALL }));
+	CHECK(decoder.next() == StateDeltaDecoder::RESULT_CORRUPT);
+}
+
+HOST_TEST(corrupt_headers_and_records_are_rejected) {
+	std::vector<uint8_t> good;
+	StateDeltaEncoder::write_header(good, 10);
+
+	std::vector<uint8_t> bad_magic = good;
+	bad_magic[0] = 'X';
+	CHECK(decode_first(bad_magic) == StateDeltaDecoder::RESULT_CORRUPT);
+
+	std::vector<uint8_t> bad_version = { 'B', 'M', 'D', 'S', 99, 10 };
+	CHECK(decode_first(bad_version) == StateDeltaDecoder::RESULT_CORRUPT);
+
+	// Truncated header: a live stream that has not been flushed yet, not corruption.
+	std::vector<uint8_t> truncated(good.begin(), good.begin() + 3);
+	CHECK(decode_first(truncated) == StateDeltaDecoder::RESULT_INCOMPLETE);
+	CHECK(decode_first(good) == StateDeltaDecoder::RESULT_END);
+
+	CHECK(decode_first(stream_with_record(7, { 0 })) == StateDeltaDecoder::RESULT_CORRUPT);
+	// A delta with no keyframe before it has nothing to apply to.
+	CHECK(decode_first(stream_with_record(STREAM_RECORD_DELTA, { 1, 0, 0, 0, 0, 0, 0, 0 })) == StateDeltaDecoder::RESULT_CORRUPT);
+	// Entity count larger than the bytes left in the record.
+	std::vector<uint8_t> too_many_players = { 0, 1, 1, 1, 0, 0xFF, 0x7F };
+	CHECK(decode_first(stream_with_record(STREAM_RECORD_KEYFRAME, too_many_players)) == StateDeltaDecoder::RESULT_CORRUPT);
+}